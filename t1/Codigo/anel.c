@@ -0,0 +1,116 @@
+// anel.c
+// fila circular de caracteres, para um produtor e um consumidor
+// simulador de computador
+// so24b
+
+#include "anel.h"
+
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <assert.h>
+
+struct anel_t {
+  unsigned mascara;            // capacidade - 1
+  char *dados;
+  // escrito só pelo consumidor: índice do próximo caractere a retirar
+  _Atomic unsigned inicio;
+  // escrito só pelo produtor: índice da próxima posição a preencher
+  _Atomic unsigned fim;
+};
+
+anel_t *anel_cria(int capacidade)
+{
+  anel_t *self = malloc(sizeof(*self));
+  assert(self != NULL);
+
+  unsigned cap = 1;
+  while (cap < capacidade) cap *= 2;
+  self->mascara = cap - 1;
+  self->dados = malloc(cap);
+  assert(self->dados != NULL);
+  atomic_init(&self->inicio, 0);
+  atomic_init(&self->fim, 0);
+
+  return self;
+}
+
+void anel_destroi(anel_t *self)
+{
+  free(self->dados);
+  free(self);
+}
+
+int anel_n(anel_t *self)
+{
+  unsigned fim = atomic_load_explicit(&self->fim, memory_order_acquire);
+  unsigned inicio = atomic_load_explicit(&self->inicio, memory_order_acquire);
+  return fim - inicio;
+}
+
+int anel_livre(anel_t *self)
+{
+  return self->mascara + 1 - anel_n(self);
+}
+
+bool anel_vazio(anel_t *self)
+{
+  return anel_n(self) == 0;
+}
+
+// PRODUTOR
+
+int anel_insere_bloco(anel_t *self, const int *valores, int n)
+{
+  unsigned fim = atomic_load_explicit(&self->fim, memory_order_relaxed);
+  unsigned inicio = atomic_load_explicit(&self->inicio, memory_order_acquire);
+  unsigned livre = self->mascara + 1 - (fim - inicio);
+  if (n > livre) n = livre;
+  for (int i = 0; i < n; i++) {
+    self->dados[(fim + i) & self->mascara] = valores[i];
+  }
+  // publica os dados junto com o novo fim
+  atomic_store_explicit(&self->fim, fim + n, memory_order_release);
+  return n;
+}
+
+bool anel_insere(anel_t *self, char ch)
+{
+  int valor = ch;
+  return anel_insere_bloco(self, &valor, 1) == 1;
+}
+
+// CONSUMIDOR
+
+int anel_retira_bloco(anel_t *self, int *valores, int n)
+{
+  unsigned inicio = atomic_load_explicit(&self->inicio, memory_order_relaxed);
+  unsigned fim = atomic_load_explicit(&self->fim, memory_order_acquire);
+  unsigned disponiveis = fim - inicio;
+  if (n > disponiveis) n = disponiveis;
+  for (int i = 0; i < n; i++) {
+    valores[i] = (unsigned char)self->dados[(inicio + i) & self->mascara];
+  }
+  // libera as posições para o produtor
+  atomic_store_explicit(&self->inicio, inicio + n, memory_order_release);
+  return n;
+}
+
+bool anel_retira(anel_t *self, char *pch)
+{
+  int valor;
+  if (anel_retira_bloco(self, &valor, 1) != 1) return false;
+  *pch = valor;
+  return true;
+}
+
+void anel_espia(anel_t *self, char *str, int tam)
+{
+  unsigned inicio = atomic_load_explicit(&self->inicio, memory_order_relaxed);
+  unsigned fim = atomic_load_explicit(&self->fim, memory_order_acquire);
+  unsigned n = fim - inicio;
+  if (n > tam - 1) n = tam - 1;
+  for (int i = 0; i < n; i++) {
+    str[i] = self->dados[(inicio + i) & self->mascara];
+  }
+  str[n] = '\0';
+}
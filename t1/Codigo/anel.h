@@ -0,0 +1,56 @@
+// anel.h
+// fila circular de caracteres, para um produtor e um consumidor
+// simulador de computador
+// so24b
+
+#ifndef ANEL_H
+#define ANEL_H
+
+// Fila de capacidade fixa, sem travas: um único produtor (que só usa as
+//   funções de inserção) e um único consumidor (que só usa as de retirada e
+//   anel_espia) podem usá-la ao mesmo tempo, em threads diferentes. As demais
+//   consultas podem ser feitas por qualquer um dos dois, mas o valor pode
+//   estar desatualizado quando for usado.
+// Os índices de início e fim só crescem (a posição no vetor é o índice
+//   módulo a capacidade, que é uma potência de 2); cada um é escrito só por
+//   um dos lados, com ordem de memória release/acquire.
+
+#include <stdbool.h>
+
+typedef struct anel_t anel_t;
+
+// cria uma fila com capacidade para pelo menos 'capacidade' caracteres
+//   (arredondada para uma potência de 2)
+anel_t *anel_cria(int capacidade);
+
+// destrói a fila
+void anel_destroi(anel_t *self);
+
+// número de caracteres na fila, e de posições livres
+int anel_n(anel_t *self);
+int anel_livre(anel_t *self);
+bool anel_vazio(anel_t *self);
+
+// PRODUTOR
+
+// insere um caractere; retorna false se a fila estiver cheia
+bool anel_insere(anel_t *self, char ch);
+
+// insere até 'n' caracteres de 'valores' (convertidos para char)
+// retorna quantos foram inseridos
+int anel_insere_bloco(anel_t *self, const int *valores, int n);
+
+// CONSUMIDOR
+
+// retira um caractere; retorna false se a fila estiver vazia
+bool anel_retira(anel_t *self, char *pch);
+
+// retira até 'n' caracteres, colocando-os em 'valores'
+// retorna quantos foram retirados
+int anel_retira_bloco(anel_t *self, int *valores, int n);
+
+// copia para 'str' até 'tam'-1 caracteres do início da fila, sem retirar,
+//   e termina com '\0'
+void anel_espia(anel_t *self, char *str, int tam);
+
+#endif // ANEL_H
@@ -0,0 +1,26 @@
+; programa para medir o desempenho do simulador
+; faz 200000 chamadas de sistema, que o SO atende sem bloquear o processo
+;   (espera por um processo que não existe, retorna -1 na hora)
+; executado como processo inicial ("./main -i bench_chamadas.maq")
+
+SO_MATA_PROC   define 8
+SO_ESPERA_PROC define 9
+
+         cargi 200000
+         armm cont
+laco     cargi 999
+         trax
+         cargi SO_ESPERA_PROC
+         chamas
+         cargm cont
+         sub um
+         armm cont
+         desvnz laco
+         ; morre
+         cargi 0
+         trax
+         cargi SO_MATA_PROC
+         chamas
+
+cont     espaco 1
+um       valor 1
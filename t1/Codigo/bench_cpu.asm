@@ -0,0 +1,24 @@
+; programa para medir o desempenho do simulador
+; só executa instruções da CPU, sem chamadas de sistema, em dois laços
+;   aninhados (1000 x 1000 voltas, pouco mais de 2 milhões de instruções)
+; executado como processo inicial ("./main -i bench_cpu.maq")
+
+SO_MATA_PROC   define 8
+
+         cargi 1000
+         armm ext
+laco_ext cargi 1000
+laco_int sub um
+         desvnz laco_int
+         cargm ext
+         sub um
+         armm ext
+         desvnz laco_ext
+         ; morre
+         cargi 0
+         trax
+         cargi SO_MATA_PROC
+         chamas
+
+ext      espaco 1
+um       valor 1
@@ -0,0 +1,329 @@
+// bench_fila.c
+// compara as filas de prontos do SO com as implementações anteriores
+// simulador de computador
+// so24b
+
+// executa a mesma sequência de eventos de escalonamento (preempção, bloqueio
+//   e desbloqueio) na fila de fila.c e numa cópia da fila que existia em
+//   so.c, que alocava um nó a cada inserção, e informa o tempo e o número de
+//   alocações por evento
+// as alocações são contadas interceptando malloc e companhia na ligação
+//   (-Wl,--wrap), o que só pega as chamadas feitas por este programa e por
+//   fila.o
+// depois, compara a lista de fila.c com o heap de fila_prio.c quando as
+//   prioridades são diferentes, como no escalonador com prioridade: a cada
+//   evento o primeiro da fila tem a prioridade recalculada com a fórmula de
+//   calcula_prioridade (com uma fração aleatória do quantum) e volta à fila
+// não faz parte do "all"; use "make bench_fila; ./bench_fila [eventos]"
+
+#include "fila.h"
+#include "fila_prio.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define EVENTOS 1000000
+
+// CONTAGEM DE ALOCAÇÕES
+
+static long alocacoes;
+static long liberacoes;
+
+void *__real_malloc(size_t tam);
+void *__real_calloc(size_t n, size_t tam);
+void *__real_realloc(void *p, size_t tam);
+void __real_free(void *p);
+
+void *__wrap_malloc(size_t tam)
+{
+  alocacoes++;
+  return __real_malloc(tam);
+}
+
+void *__wrap_calloc(size_t n, size_t tam)
+{
+  alocacoes++;
+  return __real_calloc(n, tam);
+}
+
+void *__wrap_realloc(void *p, size_t tam)
+{
+  alocacoes++;
+  return __real_realloc(p, tam);
+}
+
+void __wrap_free(void *p)
+{
+  if (p != NULL) liberacoes++;
+  __real_free(p);
+}
+
+// A FILA ANTIGA
+
+typedef struct no {
+  processo_t *processo;
+  struct no *proximo;
+  struct no *anterior;
+} no_t;
+
+typedef struct {
+  no_t *inicio;
+  no_t *fim;
+} fila_nos_t;
+
+static void nos_remove(fila_nos_t *self, processo_t *proc)
+{
+  for (no_t *no = self->inicio; no != NULL; no = no->proximo) {
+    if (no->processo != proc) continue;
+    if (no->anterior != NULL) no->anterior->proximo = no->proximo;
+    else self->inicio = no->proximo;
+    if (no->proximo != NULL) no->proximo->anterior = no->anterior;
+    else self->fim = no->anterior;
+    free(no);
+    break;
+  }
+}
+
+static void nos_insere(fila_nos_t *self, processo_t *proc)
+{
+  no_t *no = malloc(sizeof(no_t));
+  no->processo = proc;
+  no->anterior = NULL;
+  no->proximo = NULL;
+  if (self->inicio == NULL) {
+    self->inicio = self->fim = no;
+    return;
+  }
+  no_t *atual = self->inicio;
+  while (atual != NULL && atual->processo->prioridade >= proc->prioridade) {
+    atual = atual->proximo;
+  }
+  if (atual == NULL) {
+    no->anterior = self->fim;
+    self->fim->proximo = no;
+    self->fim = no;
+  } else if (atual == self->inicio) {
+    no->proximo = self->inicio;
+    self->inicio->anterior = no;
+    self->inicio = no;
+  } else {
+    no->proximo = atual;
+    no->anterior = atual->anterior;
+    atual->anterior->proximo = no;
+    atual->anterior = no;
+  }
+}
+
+static processo_t *nos_primeiro(fila_nos_t *self)
+{
+  return self->inicio == NULL ? NULL : self->inicio->processo;
+}
+
+// OS EVENTOS
+
+// o que acontece ao processo no início da fila, ou a um bloqueado
+typedef enum { PREEMPCAO, BLOQUEIO, DESBLOQUEIO } evento_t;
+
+// gerador pseudo-aleatório simples, para as duas filas verem a mesma sequência
+static unsigned semente;
+static unsigned aleatorio(void)
+{
+  semente = semente * 1103515245 + 12345;
+  return semente >> 16;
+}
+
+// o próximo evento: metade preempções, e o resto dividido entre bloqueios e
+//   desbloqueios, mantendo pelo menos um pronto e um bloqueado quando possível
+static evento_t proximo_evento(int n_prontos, int n_bloqueados)
+{
+  if (n_bloqueados > 0 && n_prontos == 0) return DESBLOQUEIO;
+  unsigned r = aleatorio() % 4;
+  if (r < 2) return PREEMPCAO;
+  if (r == 2 && n_prontos > 1) return BLOQUEIO;
+  if (n_bloqueados > 0) return DESBLOQUEIO;
+  return PREEMPCAO;
+}
+
+static double agora(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+typedef struct {
+  double tempo;
+  long alocacoes;
+  long liberacoes;
+  long soma;   // soma dos pids escolhidos, para comparar as duas filas
+} medida_t;
+
+// executa 'n_eventos' com 'n_procs' processos, na fila nova (se 'nova') ou
+//   na antiga; os bloqueados ficam numa pilha à parte
+static medida_t executa(bool nova, int n_procs, long n_eventos,
+                        processo_t *procs, processo_t **bloqueados)
+{
+  memset(procs, 0, n_procs * sizeof(*procs));
+  for (int i = 0; i < n_procs; i++) {
+    procs[i].pid = i + 1;
+    procs[i].prioridade = 0.5;
+  }
+  fila_t *fila = fila_cria();
+  fila_nos_t nos = { NULL, NULL };
+  for (int i = 0; i < n_procs; i++) {
+    if (nova) fila_insere(fila, &procs[i]);
+    else nos_insere(&nos, &procs[i]);
+  }
+  int n_prontos = n_procs;
+  int n_bloqueados = 0;
+  semente = 42;
+
+  medida_t m = { 0 };
+  long alocacoes0 = alocacoes;
+  long liberacoes0 = liberacoes;
+  double t0 = agora();
+  for (long e = 0; e < n_eventos; e++) {
+    processo_t *proc = nova ? fila_primeiro(fila) : nos_primeiro(&nos);
+    switch (proximo_evento(n_prontos, n_bloqueados)) {
+      case PREEMPCAO:
+        // como em escalonador_ROUND_ROBIN: o corrente vai para o fim
+        if (nova) {
+          fila_remove(fila, proc);
+          fila_insere(fila, proc);
+        } else {
+          nos_remove(&nos, proc);
+          nos_insere(&nos, proc);
+        }
+        break;
+      case BLOQUEIO:
+        if (nova) fila_remove(fila, proc);
+        else nos_remove(&nos, proc);
+        bloqueados[n_bloqueados++] = proc;
+        n_prontos--;
+        break;
+      case DESBLOQUEIO:
+        // um bloqueado qualquer
+        {
+          int i = aleatorio() % n_bloqueados;
+          proc = bloqueados[i];
+          bloqueados[i] = bloqueados[--n_bloqueados];
+          if (nova) fila_insere(fila, proc);
+          else nos_insere(&nos, proc);
+          n_prontos++;
+        }
+        break;
+    }
+    m.soma += proc->pid;
+  }
+  m.tempo = agora() - t0;
+  m.alocacoes = alocacoes - alocacoes0;
+  m.liberacoes = liberacoes - liberacoes0;
+
+  while (nos.inicio != NULL) nos_remove(&nos, nos.inicio->processo);
+  fila_destroi(fila);
+  return m;
+}
+
+// executa 'n_eventos' de recálculo de prioridade com 'n_procs' processos, no
+//   heap (se 'heap') ou na lista; a lista põe as prioridades maiores primeiro,
+//   então a chave no heap é o negativo da prioridade, para que as duas
+//   escolham os mesmos processos
+static medida_t executa_prio(bool heap, int n_procs, long n_eventos,
+                             processo_t *procs)
+{
+  memset(procs, 0, n_procs * sizeof(*procs));
+  semente = 42;
+  fila_t *fila = fila_cria();
+  fila_prio_t *fila_prio = fila_prio_cria();
+  for (int i = 0; i < n_procs; i++) {
+    procs[i].pid = i + 1;
+    procs[i].prioridade = (aleatorio() % 11) / 10.0;
+    if (heap) fila_prio_insere(fila_prio, &procs[i], -procs[i].prioridade);
+    else fila_insere(fila, &procs[i]);
+  }
+
+  medida_t m = { 0 };
+  long alocacoes0 = alocacoes;
+  long liberacoes0 = liberacoes;
+  double t0 = agora();
+  for (long e = 0; e < n_eventos; e++) {
+    processo_t *proc = heap ? fila_prio_primeiro(fila_prio) : fila_primeiro(fila);
+    double t_exec = aleatorio() % 11;
+    proc->prioridade = (proc->prioridade + t_exec / 10) / 2;
+    if (heap) {
+      fila_prio_insere(fila_prio, proc, -proc->prioridade);
+    } else {
+      fila_remove(fila, proc);
+      fila_insere(fila, proc);
+    }
+    m.soma += proc->pid;
+  }
+  m.tempo = agora() - t0;
+  m.alocacoes = alocacoes - alocacoes0;
+  m.liberacoes = liberacoes - liberacoes0;
+
+  fila_destroi(fila);
+  fila_prio_destroi(fila_prio);
+  return m;
+}
+
+static void imprime(int n_procs, char *nome, medida_t m, long n_eventos)
+{
+  printf("%6d %-9s %10.1f %12.3f %12.3f\n", n_procs, nome,
+         m.tempo / n_eventos * 1e9,
+         (double)m.alocacoes / n_eventos,
+         (double)m.liberacoes / n_eventos);
+}
+
+int main(int argc, char *argv[])
+{
+  long n_eventos = EVENTOS;
+  if (argc > 1) n_eventos = atol(argv[1]);
+  if (n_eventos <= 0) {
+    fprintf(stderr, "uso: %s [eventos]\n", argv[0]);
+    return 1;
+  }
+
+  int tamanhos[] = { 4, 64, 1000 };
+  printf("%ld eventos por medida\n", n_eventos);
+  printf("%6s %-9s %10s %12s %12s\n",
+         "procs", "fila", "ns/evento", "aloc/evento", "liber/evento");
+  for (int t = 0; t < sizeof(tamanhos) / sizeof(tamanhos[0]); t++) {
+    int n_procs = tamanhos[t];
+    processo_t *procs = malloc(n_procs * sizeof(*procs));
+    processo_t **bloqueados = malloc(n_procs * sizeof(*bloqueados));
+    medida_t antiga = executa(false, n_procs, n_eventos, procs, bloqueados);
+    medida_t nova = executa(true, n_procs, n_eventos, procs, bloqueados);
+    if (antiga.soma != nova.soma) {
+      fprintf(stderr, "ERRO: as filas escolheram processos diferentes\n");
+      return 1;
+    }
+    imprime(n_procs, "alocada", antiga, n_eventos);
+    imprime(n_procs, "intrusiva", nova, n_eventos);
+    free(procs);
+    free(bloqueados);
+    if (nova.alocacoes != 0) {
+      fprintf(stderr, "ERRO: a fila intrusiva alocou memória\n");
+      return 1;
+    }
+  }
+
+  int prontos[] = { 10, 100, 1000 };
+  printf("\ncom prioridades diferentes:\n");
+  for (int t = 0; t < sizeof(prontos) / sizeof(prontos[0]); t++) {
+    int n_procs = prontos[t];
+    processo_t *procs = malloc(n_procs * sizeof(*procs));
+    medida_t lista = executa_prio(false, n_procs, n_eventos, procs);
+    medida_t heap = executa_prio(true, n_procs, n_eventos, procs);
+    if (lista.soma != heap.soma) {
+      fprintf(stderr, "ERRO: a lista e o heap escolheram processos diferentes\n");
+      return 1;
+    }
+    imprime(n_procs, "lista", lista, n_eventos);
+    imprime(n_procs, "heap", heap, n_eventos);
+    free(procs);
+  }
+  return 0;
+}
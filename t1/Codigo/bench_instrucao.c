@@ -0,0 +1,136 @@
+// bench_instrucao.c
+// compara as consultas à tabela de instruções com busca linear
+// simulador de computador
+// so24b
+
+// mede o tempo de instrucao_opcode, instrucao_nome e instrucao_num_args, e
+//   de implementações com busca linear na tabela, como eram antes
+// não faz parte do "all"; use "make bench_instrucao; ./bench_instrucao"
+
+#include "instrucao.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+
+#define REPETICOES 200000
+
+// cópia da tabela, para as versões com busca linear
+static struct {
+  char nome[30];
+  int num_args;
+  int opcode;
+} tabela[N_OPCODE];
+
+static int linear_opcode(char *nome)
+{
+  for (int i = 0; i < N_OPCODE; i++) {
+    if (strcasecmp(tabela[i].nome, nome) == 0) {
+      return tabela[i].opcode;
+    }
+  }
+  return -1;
+}
+
+static char *linear_nome(int opcode)
+{
+  for (int i = 0; i < N_OPCODE; i++) {
+    if (tabela[i].opcode == opcode) {
+      return tabela[i].nome;
+    }
+  }
+  return NULL;
+}
+
+static int linear_num_args(int opcode)
+{
+  for (int i = 0; i < N_OPCODE; i++) {
+    if (tabela[i].opcode == opcode) {
+      return tabela[i].num_args;
+    }
+  }
+  return -1;
+}
+
+static double agora(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// para o compilador não eliminar as chamadas
+static volatile long sumidouro;
+
+static void compara(char *nome, double t_linear, double t_tabela, long n)
+{
+  printf("%-20s linear %6.1f ns  tabela %6.1f ns  (%.1fx)\n", nome,
+         t_linear / n * 1e9, t_tabela / n * 1e9, t_linear / t_tabela);
+}
+
+int main(void)
+{
+  // os nomes a procurar, em minúsculas como nos programas, e alguns que não
+  //   são instruções (labels, que o montador também procura)
+  char nomes[N_OPCODE + 3][30];
+  int n_nomes = 0;
+  for (int op = 0; op < N_OPCODE; op++) {
+    strcpy(tabela[op].nome, instrucao_nome(op));
+    tabela[op].num_args = instrucao_num_args(op);
+    tabela[op].opcode = op;
+    for (int i = 0; ; i++) {
+      nomes[n_nomes][i] = tolower(tabela[op].nome[i]);
+      if (nomes[n_nomes][i] == '\0') break;
+    }
+    n_nomes++;
+  }
+  strcpy(nomes[n_nomes++], "impch_X");
+  strcpy(nomes[n_nomes++], "laco");
+  strcpy(nomes[n_nomes++], "ei_num");
+
+  for (int i = 0; i < n_nomes; i++) {
+    if (linear_opcode(nomes[i]) != instrucao_opcode(nomes[i])) {
+      fprintf(stderr, "ERRO: resultados diferentes para '%s'\n", nomes[i]);
+      return 1;
+    }
+  }
+
+  long n = (long)REPETICOES * n_nomes;
+  double t0 = agora();
+  for (int r = 0; r < REPETICOES; r++) {
+    for (int i = 0; i < n_nomes; i++) sumidouro += linear_opcode(nomes[i]);
+  }
+  double t1 = agora();
+  for (int r = 0; r < REPETICOES; r++) {
+    for (int i = 0; i < n_nomes; i++) sumidouro += instrucao_opcode(nomes[i]);
+  }
+  double t2 = agora();
+  compara("instrucao_opcode", t1 - t0, t2 - t1, n);
+
+  n = (long)REPETICOES * N_OPCODE;
+  t0 = agora();
+  for (int r = 0; r < REPETICOES; r++) {
+    for (int op = 0; op < N_OPCODE; op++) sumidouro += (long)linear_nome(op);
+  }
+  t1 = agora();
+  for (int r = 0; r < REPETICOES; r++) {
+    for (int op = 0; op < N_OPCODE; op++) sumidouro += (long)instrucao_nome(op);
+  }
+  t2 = agora();
+  compara("instrucao_nome", t1 - t0, t2 - t1, n);
+
+  t0 = agora();
+  for (int r = 0; r < REPETICOES; r++) {
+    for (int op = 0; op < N_OPCODE; op++) sumidouro += linear_num_args(op);
+  }
+  t1 = agora();
+  for (int r = 0; r < REPETICOES; r++) {
+    for (int op = 0; op < N_OPCODE; op++) sumidouro += instrucao_num_args(op);
+  }
+  t2 = agora();
+  compara("instrucao_num_args", t1 - t0, t2 - t1, n);
+
+  return 0;
+}
@@ -0,0 +1,445 @@
+// bench_mips.c
+// mede o desempenho do simulador em um conjunto fixo de cargas
+// simulador de computador
+// so24b
+
+// executa o simulador ("./main -H", sem tela) várias vezes para cada carga,
+//   e mede o tempo de relógio, o tempo de CPU e, se o sistema permitir, o
+//   número de instruções executadas pelo processador hospedeiro
+// o número de instruções simuladas vem da linha "instruções executadas: N"
+//   que o simulador imprime no final; com ele, calcula os MIPS (milhões de
+//   instruções simuladas por segundo) e as instruções do hospedeiro gastas
+//   por instrução simulada
+// as cargas são longas (da ordem de 1 a 2 milhões de instruções), para que o
+//   tempo medido seja o do interpretador e não o de criar o processo e
+//   inicializar o simulador: os programas que rodam sob o SO são repetidos
+//   por bench_repete, e os que rodam sem SO recebem uma entrada que os faz
+//   repetir o seu laço (muitos chutes errados antes do certo, ou um intervalo
+//   maior de números); ex2 não lê nada e não tem como ser alongado, por isso
+//   não está entre as cargas
+// o resultado vai para a saída padrão e para os arquivos bench.json e
+//   bench.csv, para comparar execuções
+// não faz parte do "all"; use "make bench" ou, por exemplo,
+//   "./bench_mips -r 10 -w ex1,p1p2p3 -- -m blocos"
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#define REPETICOES_PADRAO 5
+#define MAX_REPETICOES 100
+#define MAX_ARGS 32
+#define TAM_SAIDA 65536
+
+// uma carga: os argumentos do simulador e, se o programa lê de um terminal,
+//   o que é digitado nele: 'entrada' repetida 'vezes' vezes (uma, se 0),
+//   seguida de 'fim'
+typedef struct {
+  char *nome;
+  char *descricao;
+  char *args[6];
+  char terminal;        // terminal de entrada, ou '\0'
+  char *entrada;
+  int vezes;
+  char *fim;
+} carga_t;
+
+// bench_repete fica depois dos outros programas, precisa de mais memória
+#define REPETE "-M", "11000", "-i", "bench_repete.maq"
+
+static carga_t cargas[] = {
+  { "p1p2p3",   "init (cria p1, p2 e p3) 100 vezes",
+    { REPETE }, 'A', "init.maq\n100\n" },
+  { "ex1",      "ex1 sob o SO 5000 vezes",
+    { REPETE }, 'A', "ex1.maq\n5000\n" },
+  { "ex3",      "ex3 sob o SO 1000 vezes",
+    { REPETE }, 'A', "ex3.maq\n1000\n" },
+  { "ex4",      "ex4 sem SO, 2500 chutes errados no terminal A",
+    { "-x", "ex4.maq" }, 'A', "a", 2500, "k\n" },
+  { "ex5",      "ex5 sem SO, 2000 chutes errados no terminal B",
+    { "-x", "ex5.maq" }, 'B', "50\n", 2000, "42\n" },
+  { "ex6",      "ex6 sem SO, imprime de 1 a 4000 no terminal B",
+    { "-x", "ex6.maq" }, 'B', "1 4000\n" },
+  { "cpu",      "laço só com instruções da CPU",  { "-i", "bench_cpu.maq" } },
+  { "chamadas", "laço de chamadas de sistema",    { "-i", "bench_chamadas.maq" } },
+};
+#define N_CARGAS (sizeof(cargas) / sizeof(cargas[0]))
+
+// o resultado de uma execução
+typedef struct {
+  double tempo;         // tempo de relógio, em s
+  double cpu;           // tempo de CPU (usuário + sistema), em s
+  long instrucoes;      // instruções simuladas
+  long long hospedeiro; // instruções do hospedeiro, -1 se não medido
+} medida_t;
+
+// o resumo das execuções de uma carga
+typedef struct {
+  double min, mediana, media, desvio;
+  double cpu;
+  long instrucoes;
+  long long hospedeiro;
+} resumo_t;
+
+static double agora(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// CONTADOR DE INSTRUÇÕES DO HOSPEDEIRO
+
+// abre um contador de instruções (em modo usuário) para o processo 'pid' e
+//   suas threads, que começa a contar quando o processo fizer exec
+// retorna -1 se não for possível (sem permissão, em máquina virtual, etc)
+static int abre_contador(pid_t pid)
+{
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+  attr.disabled = 1;
+  attr.enable_on_exec = 1;
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return syscall(SYS_perf_event_open, &attr, pid, -1, -1, 0);
+}
+
+static long long le_contador(int fd)
+{
+  long long valor;
+  if (fd < 0 || read(fd, &valor, sizeof(valor)) != sizeof(valor)) return -1;
+  return valor;
+}
+
+// EXECUÇÃO
+
+// executa o simulador uma vez, com os argumentos em 'args'
+// retorna false (e imprime o motivo) se a execução não foi bem sucedida
+static bool executa(char *args[], medida_t *med)
+{
+  int saida[2], sinal[2];
+  if (pipe(saida) < 0 || pipe(sinal) < 0) {
+    perror("pipe");
+    return false;
+  }
+  double t0 = agora();
+  pid_t pid = fork();
+  if (pid < 0) {
+    perror("fork");
+    return false;
+  }
+  if (pid == 0) {
+    // espera o contador ser aberto antes de fazer o exec
+    char ch;
+    close(sinal[1]);
+    if (read(sinal[0], &ch, 1) < 0) _exit(127);
+    close(saida[0]);
+    dup2(saida[1], STDOUT_FILENO);
+    execv(args[0], args);
+    perror(args[0]);
+    _exit(127);
+  }
+  close(sinal[0]);
+  close(saida[1]);
+  int contador = abre_contador(pid);
+  if (write(sinal[1], "", 1) < 0) perror("write");
+  close(sinal[1]);
+
+  // lê toda a saída; a linha das instruções está no final
+  static char texto[TAM_SAIDA];
+  int n = 0;
+  for (;;) {
+    ssize_t lidos = read(saida[0], texto + n, sizeof(texto) - 1 - n);
+    if (lidos <= 0) break;
+    n += lidos;
+    if (n == sizeof(texto) - 1) {
+      // guarda só o final
+      memmove(texto, texto + n / 2, n - n / 2);
+      n -= n / 2;
+    }
+  }
+  texto[n] = '\0';
+  close(saida[0]);
+
+  int estado;
+  struct rusage uso;
+  wait4(pid, &estado, 0, &uso);
+  med->tempo = agora() - t0;
+  med->cpu = uso.ru_utime.tv_sec + uso.ru_utime.tv_usec / 1e6
+           + uso.ru_stime.tv_sec + uso.ru_stime.tv_usec / 1e6;
+  med->hospedeiro = le_contador(contador);
+  if (contador >= 0) close(contador);
+
+  if (!WIFEXITED(estado) || WEXITSTATUS(estado) != 0) {
+    fprintf(stderr, "  o simulador terminou com erro (estado %d)\n", estado);
+    return false;
+  }
+  char *linha = strstr(texto, "instruções executadas:");
+  if (linha == NULL
+      || sscanf(linha, "instruções executadas: %ld", &med->instrucoes) != 1) {
+    fprintf(stderr, "  o simulador não informou as instruções executadas\n");
+    return false;
+  }
+  return true;
+}
+
+// cria em 'dir' o arquivo com a entrada da carga, e retorna seu nome
+static char *cria_entrada(char *dir, carga_t *carga)
+{
+  static char nome[300];
+  snprintf(nome, sizeof(nome), "%s/%s.txt", dir, carga->nome);
+  FILE *arq = fopen(nome, "w");
+  if (arq == NULL) {
+    perror(nome);
+    exit(1);
+  }
+  for (int i = 0; i < carga->vezes || i == 0; i++) fputs(carga->entrada, arq);
+  if (carga->fim != NULL) fputs(carga->fim, arq);
+  fclose(arq);
+  return nome;
+}
+
+// ESTATÍSTICA
+
+static int compara_double(const void *a, const void *b)
+{
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+static int compara_ll(const void *a, const void *b)
+{
+  long long x = *(const long long *)a, y = *(const long long *)b;
+  return (x > y) - (x < y);
+}
+
+static void resume(medida_t med[], int n, resumo_t *res)
+{
+  double tempos[MAX_REPETICOES], cpus[MAX_REPETICOES];
+  long long hosp[MAX_REPETICOES];
+  double soma = 0;
+  res->hospedeiro = 0;
+  for (int i = 0; i < n; i++) {
+    tempos[i] = med[i].tempo;
+    cpus[i] = med[i].cpu;
+    hosp[i] = med[i].hospedeiro;
+    soma += med[i].tempo;
+  }
+  qsort(tempos, n, sizeof(double), compara_double);
+  qsort(cpus, n, sizeof(double), compara_double);
+  qsort(hosp, n, sizeof(long long), compara_ll);
+  res->min = tempos[0];
+  res->mediana = tempos[n / 2];
+  if (n % 2 == 0) res->mediana = (tempos[n / 2 - 1] + tempos[n / 2]) / 2;
+  res->media = soma / n;
+  double var = 0;
+  for (int i = 0; i < n; i++) {
+    var += (tempos[i] - res->media) * (tempos[i] - res->media);
+  }
+  res->desvio = n > 1 ? sqrt(var / (n - 1)) : 0;
+  res->cpu = cpus[n / 2];
+  // a execução é determinística, todas executam as mesmas instruções
+  res->instrucoes = med[0].instrucoes;
+  // sem contador em alguma execução, não informa
+  res->hospedeiro = hosp[0] < 0 ? -1 : hosp[n / 2];
+}
+
+static double mips(resumo_t *res)
+{
+  return res->instrucoes / res->mediana / 1e6;
+}
+
+// SAÍDA
+
+static void imprime_cabecalho(void)
+{
+  printf("%-9s %6s %11s %9s %9s %9s %7s %9s %8s\n", "carga", "exec",
+         "instruções", "min(s)", "mediana", "desvio", "MIPS", "cpu(s)",
+         "hosp/ins");
+}
+
+static void imprime_resumo(carga_t *carga, int n, resumo_t *res)
+{
+  printf("%-9s %6d %11ld %9.4f %9.4f %9.4f %7.2f %9.4f", carga->nome, n,
+         res->instrucoes, res->min, res->mediana, res->desvio, mips(res),
+         res->cpu);
+  if (res->hospedeiro >= 0) {
+    printf(" %8.1f\n", (double)res->hospedeiro / res->instrucoes);
+  } else {
+    printf(" %8s\n", "-");
+  }
+}
+
+static void grava_csv(FILE *arq, carga_t *carga, int n, resumo_t *res)
+{
+  fprintf(arq, "%s,%d,%ld,%.6f,%.6f,%.6f,%.6f,%.3f,%.6f,", carga->nome, n,
+          res->instrucoes, res->min, res->mediana, res->media, res->desvio,
+          mips(res), res->cpu);
+  if (res->hospedeiro >= 0) fprintf(arq, "%lld", res->hospedeiro);
+  fprintf(arq, "\n");
+}
+
+static void grava_json(FILE *arq, bool primeira, carga_t *carga, int n,
+                       resumo_t *res)
+{
+  fprintf(arq, "%s    {\"carga\": \"%s\", \"repeticoes\": %d, "
+          "\"instrucoes\": %ld,\n", primeira ? "" : ",\n", carga->nome, n,
+          res->instrucoes);
+  fprintf(arq, "     \"tempo_s\": {\"min\": %.6f, \"mediana\": %.6f, "
+          "\"media\": %.6f, \"desvio\": %.6f},\n", res->min, res->mediana,
+          res->media, res->desvio);
+  fprintf(arq, "     \"mips\": %.3f, \"cpu_s\": %.6f, ", mips(res), res->cpu);
+  if (res->hospedeiro >= 0) {
+    fprintf(arq, "\"instrucoes_hospedeiro\": %lld}", res->hospedeiro);
+  } else {
+    fprintf(arq, "\"instrucoes_hospedeiro\": null}");
+  }
+}
+
+// verifica se a carga está na lista 'filtro' (nomes separados por vírgula)
+static bool selecionada(carga_t *carga, char *filtro)
+{
+  if (filtro == NULL) return true;
+  int tam = strlen(carga->nome);
+  for (char *p = filtro; p != NULL; p = strchr(p, ',')) {
+    if (*p == ',') p++;
+    if (strncmp(p, carga->nome, tam) == 0 && (p[tam] == ',' || p[tam] == '\0')) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void uso(char *nome)
+{
+  fprintf(stderr, "uso: %s [-r repetições] [-m simulador] [-j arquivo] [-c arquivo]"
+                  " [-w cargas] [-- args]\n", nome);
+  fprintf(stderr, "  -r  execuções de cada carga (padrão %d)\n", REPETICOES_PADRAO);
+  fprintf(stderr, "  -m  o simulador a executar (padrão ./main)\n");
+  fprintf(stderr, "  -j  arquivo com o resultado em JSON (padrão bench.json)\n");
+  fprintf(stderr, "  -c  arquivo com o resultado em CSV (padrão bench.csv)\n");
+  fprintf(stderr, "  -w  cargas a executar, separadas por vírgula (padrão todas):\n");
+  for (int i = 0; i < N_CARGAS; i++) {
+    fprintf(stderr, "        %-9s %s\n", cargas[i].nome, cargas[i].descricao);
+  }
+  fprintf(stderr, "  args são passados ao simulador (ex: -- -m blocos)\n");
+  exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+  int repeticoes = REPETICOES_PADRAO;
+  char *simulador = "./main";
+  char *nome_json = "bench.json";
+  char *nome_csv = "bench.csv";
+  char *filtro = NULL;
+  int c;
+  while ((c = getopt(argc, argv, "r:m:j:c:w:")) != -1) {
+    switch (c) {
+      case 'r':
+        repeticoes = atoi(optarg);
+        if (repeticoes < 1 || repeticoes > MAX_REPETICOES) uso(argv[0]);
+        break;
+      case 'm': simulador = optarg; break;
+      case 'j': nome_json = optarg; break;
+      case 'c': nome_csv = optarg; break;
+      case 'w': filtro = optarg; break;
+      default: uso(argv[0]);
+    }
+  }
+  int n_extras = argc - optind;
+  if (n_extras > MAX_ARGS - 12) uso(argv[0]);
+
+  char dir[] = "/tmp/bench.XXXXXX";
+  if (mkdtemp(dir) == NULL) {
+    perror("mkdtemp");
+    return 1;
+  }
+  FILE *json = fopen(nome_json, "w");
+  FILE *csv = fopen(nome_csv, "w");
+  if (json == NULL || csv == NULL) {
+    perror("bench");
+    return 1;
+  }
+  fprintf(json, "{\n  \"simulador\": \"%s\",\n  \"args\": [", simulador);
+  for (int i = 0; i < n_extras; i++) {
+    fprintf(json, "%s\"%s\"", i == 0 ? "" : ", ", argv[optind + i]);
+  }
+  fprintf(json, "],\n  \"cargas\": [\n");
+  fprintf(csv, "carga,repeticoes,instrucoes,min_s,mediana_s,media_s,desvio_s,"
+               "mips,cpu_s,instrucoes_hospedeiro\n");
+
+  imprime_cabecalho();
+  bool primeira = true;
+  bool ok = true;
+  for (int i = 0; i < N_CARGAS; i++) {
+    carga_t *carga = &cargas[i];
+    if (!selecionada(carga, filtro)) continue;
+
+    // ./main -H -v erro [args da carga] [-e t:entrada] [args extras]
+    char *args[MAX_ARGS];
+    char arg_entrada[320];
+    int n = 0;
+    args[n++] = simulador;
+    args[n++] = "-H";
+    args[n++] = "-v";
+    args[n++] = "erro";
+    for (int a = 0; carga->args[a] != NULL; a++) args[n++] = carga->args[a];
+    if (carga->terminal != '\0') {
+      snprintf(arg_entrada, sizeof(arg_entrada), "%c:%s", carga->terminal,
+               cria_entrada(dir, carga));
+      args[n++] = "-e";
+      args[n++] = arg_entrada;
+    }
+    for (int a = 0; a < n_extras; a++) args[n++] = argv[optind + a];
+    args[n] = NULL;
+
+    medida_t med[MAX_REPETICOES];
+    int r;
+    for (r = 0; r < repeticoes; r++) {
+      if (!executa(args, &med[r])) break;
+    }
+    if (r < repeticoes) {
+      fprintf(stderr, "%s: falhou na execução %d\n", carga->nome, r + 1);
+      ok = false;
+      continue;
+    }
+    resumo_t res;
+    resume(med, repeticoes, &res);
+    imprime_resumo(carga, repeticoes, &res);
+    grava_csv(csv, carga, repeticoes, &res);
+    grava_json(json, primeira, carga, repeticoes, &res);
+    primeira = false;
+  }
+  fprintf(json, "\n  ]\n}\n");
+  fclose(json);
+  fclose(csv);
+
+  // apaga as entradas e o diretório temporário
+  for (int i = 0; i < N_CARGAS; i++) {
+    if (cargas[i].terminal == '\0') continue;
+    char nome[300];
+    snprintf(nome, sizeof(nome), "%s/%s.txt", dir, cargas[i].nome);
+    unlink(nome);
+  }
+  rmdir(dir);
+
+  return ok ? 0 : 1;
+}
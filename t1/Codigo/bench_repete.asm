@@ -0,0 +1,72 @@
+; programa para medir o desempenho do simulador
+; executa outro programa várias vezes seguidas, para que a carga do
+;   simulador fique pequena perto da execução
+; lê do seu terminal (o A, o do processo inicial) uma linha com o nome do
+;   programa e outra com o número de repetições; cria o processo e espera ele
+;   terminar, tantas vezes quantas pedidas
+; executado como processo inicial ("./main -M 11000 -i bench_repete.maq
+;   -e A:arquivo"); fica depois de todos os outros programas, para poder
+;   repetir qualquer um deles, inclusive o init
+
+SO_LE          define 1
+SO_CRIA_PROC   define 7
+SO_MATA_PROC   define 8
+SO_ESPERA_PROC define 9
+
+         ; lê o nome do programa
+         cargi 0
+         trax
+le_nome  chama lelin
+         desvz nome_ok
+         armx nome
+         incx
+         desv le_nome
+nome_ok  armx nome
+         ; lê o número de repetições
+le_num   chama lelin
+         desvz repete
+         sub ch_0
+         armm digito
+         cargm vezes
+         mult dez
+         soma digito
+         armm vezes
+         desv le_num
+         ; executa o programa
+repete   cargm vezes
+         desvz morre
+         sub um
+         armm vezes
+         cargi nome
+         trax
+         cargi SO_CRIA_PROC
+         chamas
+         trax
+         cargi SO_ESPERA_PROC
+         chamas
+         desv repete
+morre    cargi 0
+         trax
+         cargi SO_MATA_PROC
+         chamas
+
+; lê um caractere do terminal; retorna em A o caractere, ou 0 no fim da
+;   linha
+; não altera o valor de X
+lelin    espaco 1
+         cargi SO_LE
+         chamas
+         armm lelin_ch
+         sub fim_lin
+         desvz lelin_f
+         cargm lelin_ch
+lelin_f  ret lelin
+lelin_ch espaco 1
+
+vezes    valor 0
+digito   espaco 1
+um       valor 1
+dez      valor 10
+ch_0     valor '0'
+fim_lin  valor 10
+nome     espaco 40
@@ -0,0 +1,257 @@
+// blocos.c
+// cache de tradução de blocos básicos, para o motor de blocos da CPU
+// simulador de computador
+// so24b
+
+#include "blocos.h"
+#include "instrucao.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+// número máximo de instruções em um bloco
+#define MAX_INSTR_BLOCO 64
+// em modo usuário, não se pode executar antes desse endereço
+#define END_MIN_USUARIO 100
+
+struct blocos_t {
+  mem_t *mem;
+  int tam;              // tamanho da memória
+  bloco_t **por_pc;     // o bloco que começa em cada endereço (ou NULL)
+  bool *eh_codigo;      // se cada endereço faz parte de algum bloco
+  bloco_t *alocados;    // lista com todos os blocos
+  bool sujo;            // se algum bloco foi invalidado por uma escrita
+  // contadores
+  long acertos;
+  long faltas;
+  long encadeamentos;
+  long invalidacoes;
+};
+
+blocos_t *blocos_cria(mem_t *mem)
+{
+  blocos_t *self = malloc(sizeof(*self));
+  assert(self != NULL);
+
+  self->mem = mem;
+  self->tam = mem_tam(mem);
+  self->por_pc = calloc(self->tam, sizeof(*self->por_pc));
+  assert(self->por_pc != NULL);
+  self->eh_codigo = calloc(self->tam, sizeof(*self->eh_codigo));
+  assert(self->eh_codigo != NULL);
+  self->alocados = NULL;
+  self->sujo = false;
+  self->acertos = 0;
+  self->faltas = 0;
+  self->encadeamentos = 0;
+  self->invalidacoes = 0;
+
+  return self;
+}
+
+// libera todos os blocos
+static void blocos_limpa(blocos_t *self)
+{
+  while (self->alocados != NULL) {
+    bloco_t *b = self->alocados;
+    self->alocados = b->prox_alocado;
+    free(b);
+  }
+  memset(self->por_pc, 0, self->tam * sizeof(*self->por_pc));
+  memset(self->eh_codigo, 0, self->tam * sizeof(*self->eh_codigo));
+  self->sujo = false;
+}
+
+void blocos_destroi(blocos_t *self)
+{
+  blocos_limpa(self);
+  free(self->por_pc);
+  free(self->eh_codigo);
+  free(self);
+}
+
+// TRADUÇÃO
+
+// retorna a uop que corresponde ao opcode, ou -1 se a instrução não é
+//   traduzida (as privilegiadas e as que causam interrupção)
+static int uop_da_instrucao(int opcode)
+{
+  switch (opcode) {
+    case NOP:    return UOP_NOP;
+    case CARGI:  return UOP_CARGI;
+    case CARGM:  return UOP_CARGM;
+    case CARGX:  return UOP_CARGX;
+    case ARMM:   return UOP_ARMM;
+    case ARMX:   return UOP_ARMX;
+    case TRAX:   return UOP_TRAX;
+    case CPXA:   return UOP_CPXA;
+    case INCX:   return UOP_INCX;
+    case SOMA:   return UOP_SOMA;
+    case SUB:    return UOP_SUB;
+    case MULT:   return UOP_MULT;
+    case DIV:    return UOP_DIV;
+    case RESTO:  return UOP_RESTO;
+    case NEG:    return UOP_NEG;
+    case DESV:   return UOP_DESV;
+    case DESVZ:  return UOP_DESVZ;
+    case DESVNZ: return UOP_DESVNZ;
+    case DESVN:  return UOP_DESVN;
+    case DESVP:  return UOP_DESVP;
+    case CHAMA:  return UOP_CHAMA;
+    case RET:    return UOP_RET;
+    default:     return -1;
+  }
+}
+
+static bool termina_bloco(uop_cod_t cod)
+{
+  return cod >= UOP_DESV;
+}
+
+// lê a instrução em 'pc', se ela puder ser traduzida
+// uma instrução que acessa a memória em um endereço fixo inválido não é
+//   traduzida (o motor de referência gera o erro); assim, o executor de
+//   blocos pode fazer esses acessos sem verificar o endereço
+// retorna a uop correspondente (e o argumento em *pA1 e o tamanho da
+//   instrução em *ptam), ou -1
+static int le_instrucao(blocos_t *self, int pc, int *pA1, int *ptam)
+{
+  int opcode;
+  if (pc < END_MIN_USUARIO) return -1;
+  if (mem_le(self->mem, pc, &opcode) != ERR_OK) return -1;
+  // uma superinstrução é traduzida como a sua primeira instrução; as demais
+  //   continuam na memória, e são traduzidas em seguida
+  opcode = instrucao_componente(opcode, 0);
+  int cod = uop_da_instrucao(opcode);
+  if (cod < 0) return -1;
+  *pA1 = 0;
+  *ptam = 1 + instrucao_num_args(opcode);
+  if (*ptam > 1 && mem_le(self->mem, pc + 1, pA1) != ERR_OK) return -1;
+  if (instrucao_acessa_mem_A1(opcode) && !mem_faixa_valida(self->mem, *pA1, 1)) {
+    return -1;
+  }
+  return cod;
+}
+
+// tenta fundir a uop 'u' (já traduzida) com as instruções seguintes, a partir
+//   de 'pc'
+// retorna o número de palavras de memória incorporadas à uop
+static int funde(blocos_t *self, uop_t *u, int pc)
+{
+  int A2, A3, tam2, tam3;
+  int cod2 = le_instrucao(self, pc, &A2, &tam2);
+  if (u->cod == UOP_CPXA && (cod2 == UOP_SUB || cod2 == UOP_RESTO)) {
+    u->cod = (cod2 == UOP_SUB) ? UOP_CPXA_SUB : UOP_CPXA_RESTO;
+    u->a1 = A2;
+    u->n_instr = 2;
+    return tam2;
+  }
+  if (u->cod == UOP_CARGM && cod2 == UOP_SUB) {
+    u->cod = UOP_CARGM_SUB;
+    u->a2 = A2;
+    u->n_instr = 2;
+    return tam2;
+  }
+  if (u->cod == UOP_CARGM && cod2 == UOP_SOMA
+      && le_instrucao(self, pc + tam2, &A3, &tam3) == UOP_ARMM) {
+    u->cod = UOP_CARGM_SOMA_ARMM;
+    u->a2 = A2;
+    u->a3 = A3;
+    u->n_instr = 3;
+    return tam2 + tam3;
+  }
+  return 0;
+}
+
+// traduz o bloco que começa em 'pc_inicio'
+static bloco_t *traduz(blocos_t *self, int pc_inicio)
+{
+  uop_t uops[MAX_INSTR_BLOCO + 1];
+  int n_uops = 0;
+  int n_instr = 0;
+  int pc = pc_inicio;
+  bool terminou = false;
+
+  while (!terminou && n_instr < MAX_INSTR_BLOCO) {
+    int A1, tam;
+    int cod = le_instrucao(self, pc, &A1, &tam);
+    if (cod < 0) break;
+    uop_t *u = &uops[n_uops++];
+    *u = (uop_t){ .cod = cod, .pc = pc, .n_instr = 1, .a1 = A1 };
+    terminou = termina_bloco(cod);
+    if (!terminou) tam += funde(self, u, pc + tam);
+    n_instr += u->n_instr;
+    pc += tam;
+  }
+  if (n_uops > 0 && !terminou) {
+    uops[n_uops++] = (uop_t){ .cod = UOP_SEGUE, .pc = pc, .n_instr = 0, .a1 = pc };
+  }
+
+  bloco_t *b = malloc(sizeof(*b) + n_uops * sizeof(uop_t));
+  assert(b != NULL);
+  b->pc = pc_inicio;
+  b->n_instr = n_instr;
+  b->sucessor[0] = NULL;
+  b->sucessor[1] = NULL;
+  b->n_uops = n_uops;
+  memcpy(b->uops, uops, n_uops * sizeof(uop_t));
+  b->prox_alocado = self->alocados;
+  self->alocados = b;
+
+  // um bloco vazio também depende do conteúdo da memória em 'pc_inicio'
+  if (pc == pc_inicio) pc++;
+  for (int end = pc_inicio; end < pc && end < self->tam; end++) {
+    self->eh_codigo[end] = true;
+  }
+
+  return b;
+}
+
+// ACESSO
+
+bloco_t *blocos_busca(blocos_t *self, int pc)
+{
+  if (self->sujo) blocos_limpa(self);
+  if (pc < 0 || pc >= self->tam) return NULL;
+  bloco_t *b = self->por_pc[pc];
+  if (b != NULL) {
+    self->acertos++;
+    return b;
+  }
+  self->faltas++;
+  b = traduz(self, pc);
+  self->por_pc[pc] = b;
+  return b;
+}
+
+bloco_t *blocos_sucessor(blocos_t *self, bloco_t *bloco, int i, int pc)
+{
+  // com a cache suja, 'bloco' pode ser liberado pela busca
+  if (self->sujo) return NULL;
+  bloco_t *s = bloco->sucessor[i];
+  if (s != NULL && s->pc == pc) {
+    self->encadeamentos++;
+    return s;
+  }
+  s = blocos_busca(self, pc);
+  bloco->sucessor[i] = s;
+  return s;
+}
+
+bool blocos_invalida(blocos_t *self, int endereco)
+{
+  if (!self->eh_codigo[endereco]) return false;
+  if (!self->sujo) self->invalidacoes++;
+  self->sujo = true;
+  return true;
+}
+
+void blocos_concatena_estatisticas(blocos_t *self, char *str, int tam)
+{
+  int n = strlen(str);
+  snprintf(str + n, tam - n,
+           "blocos: %ld acertos, %ld encadeamentos, %ld faltas, %ld invalidações",
+           self->acertos, self->encadeamentos, self->faltas, self->invalidacoes);
+}
@@ -0,0 +1,89 @@
+// blocos.h
+// cache de tradução de blocos básicos, para o motor de blocos da CPU
+// simulador de computador
+// so24b
+
+#ifndef BLOCOS_H
+#define BLOCOS_H
+
+// Um bloco básico é uma sequência de instruções sem desvio, a partir de um
+//   endereço. Ele é traduzido para um vetor de micro-operações (uops), que
+//   já têm os argumentos lidos da memória; algumas sequências comuns de
+//   instruções são fundidas em uma só uop.
+// Só são traduzidas instruções que podem ser executadas em modo usuário; o
+//   bloco termina em um desvio, ou antes de uma instrução que não pode ser
+//   traduzida (a CPU executa essa instrução no motor de referência).
+// Os endereços fixos acessados pelas instruções (o argumento de CARGM, SOMA,
+//   ARMM, RET etc) são verificados na tradução, e não precisam ser
+//   verificados a cada execução.
+// Cada bloco guarda ponteiros para os blocos sucessores (o do desvio e o da
+//   sequência), preenchidos na primeira vez que são usados, para que a CPU
+//   passe de um bloco a outro sem consultar a cache.
+// Uma escrita na memória em um endereço que faz parte de algum bloco invalida
+//   toda a cache.
+
+#include "memoria.h"
+
+#include <stdbool.h>
+
+// as micro-operações
+typedef enum {
+  // uma instrução cada
+  UOP_NOP, UOP_CARGI, UOP_CARGM, UOP_CARGX, UOP_ARMM, UOP_ARMX,
+  UOP_TRAX, UOP_CPXA, UOP_INCX, UOP_SOMA, UOP_SUB, UOP_MULT, UOP_DIV,
+  UOP_RESTO, UOP_NEG,
+  // instruções fundidas
+  UOP_CPXA_SUB,        // CPXA; SUB a1
+  UOP_CPXA_RESTO,      // CPXA; RESTO a1
+  UOP_CARGM_SUB,       // CARGM a1; SUB a2
+  UOP_CARGM_SOMA_ARMM, // CARGM a1; SOMA a2; ARMM a3
+  // terminam o bloco
+  UOP_DESV, UOP_DESVZ, UOP_DESVNZ, UOP_DESVN, UOP_DESVP, UOP_CHAMA, UOP_RET,
+  UOP_SEGUE,           // não é instrução: o bloco continua no endereço a1
+} uop_cod_t;
+
+typedef struct {
+  uop_cod_t cod;
+  int pc;         // endereço da (primeira) instrução
+  int n_instr;    // número de instruções que a uop representa
+  int a1, a2, a3; // argumentos das instruções
+} uop_t;
+
+typedef struct bloco_t bloco_t;
+struct bloco_t {
+  int pc;                   // endereço inicial do bloco
+  int n_instr;              // número de instruções no bloco
+  bloco_t *sucessor[2];     // [0] bloco seguinte, [1] destino do desvio
+  bloco_t *prox_alocado;    // para liberar todos na invalidação
+  int n_uops;               // 0 se a instrução no início não é traduzível
+  uop_t uops[];
+};
+
+typedef struct blocos_t blocos_t;
+
+// cria uma cache de blocos para a memória 'mem'
+blocos_t *blocos_cria(mem_t *mem);
+
+// destrói a cache
+void blocos_destroi(blocos_t *self);
+
+// retorna o bloco que começa em 'pc', traduzindo se necessário
+// retorna NULL se 'pc' não é um endereço válido
+bloco_t *blocos_busca(blocos_t *self, int pc);
+
+// retorna o sucessor 'i' de 'bloco', que começa em 'pc', e guarda a ligação
+//   para as próximas vezes
+bloco_t *blocos_sucessor(blocos_t *self, bloco_t *bloco, int i, int pc);
+
+// informa que o endereço 'endereco' da memória foi alterado
+// se ele fizer parte de algum bloco, a cache fica suja e retorna true;
+//   os blocos continuam válidos até a próxima busca (para não serem
+//   liberados enquanto um deles está sendo executado), e quem está executando
+//   um bloco deve abandoná-lo
+bool blocos_invalida(blocos_t *self, int endereco);
+
+// concatena em str os contadores da cache, sem que str passe de 'tam'
+//   caracteres (contando o '\0')
+void blocos_concatena_estatisticas(blocos_t *self, char *str, int tam);
+
+#endif // BLOCOS_H
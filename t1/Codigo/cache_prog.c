@@ -0,0 +1,175 @@
+// cache_prog.c
+// cache de programas já lidos, para o carregador do SO
+// simulador de computador
+// so24b
+
+#include "cache_prog.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <sys/stat.h>
+
+typedef struct entrada_t entrada_t;
+struct entrada_t {
+  char *nome;
+  struct timespec modificacao;  // do arquivo, quando foi lido
+  off_t tam_arquivo;
+  programa_t *prog;
+  size_t memoria;               // prog_memoria(prog)
+  entrada_t *anterior;          // lista em ordem de uso, a mais recente
+  entrada_t *proxima;           //   no início
+};
+
+struct cache_prog_t {
+  size_t orcamento;
+  size_t usado;
+  entrada_t *inicio;
+  entrada_t *fim;
+  // contadores
+  long acertos;
+  long faltas;
+  long descartes;      // entradas descartadas por falta de espaço
+  long desatualizadas; // entradas descartadas porque o arquivo mudou
+};
+
+cache_prog_t *cache_prog_cria(size_t orcamento)
+{
+  cache_prog_t *self = malloc(sizeof(*self));
+  assert(self != NULL);
+
+  self->orcamento = orcamento;
+  self->usado = 0;
+  self->inicio = NULL;
+  self->fim = NULL;
+  self->acertos = 0;
+  self->faltas = 0;
+  self->descartes = 0;
+  self->desatualizadas = 0;
+
+  return self;
+}
+
+// LISTA DE ENTRADAS
+
+static void tira_da_lista(cache_prog_t *self, entrada_t *e)
+{
+  if (e->anterior != NULL) e->anterior->proxima = e->proxima;
+  else self->inicio = e->proxima;
+  if (e->proxima != NULL) e->proxima->anterior = e->anterior;
+  else self->fim = e->anterior;
+}
+
+static void poe_no_inicio(cache_prog_t *self, entrada_t *e)
+{
+  e->anterior = NULL;
+  e->proxima = self->inicio;
+  if (self->inicio != NULL) self->inicio->anterior = e;
+  else self->fim = e;
+  self->inicio = e;
+}
+
+static void remove_entrada(cache_prog_t *self, entrada_t *e)
+{
+  tira_da_lista(self, e);
+  self->usado -= e->memoria;
+  prog_destroi(e->prog);
+  free(e->nome);
+  free(e);
+}
+
+// descarta as entradas menos recentes até que 'necessario' bytes caibam
+//   no orçamento
+static void libera_espaco(cache_prog_t *self, size_t necessario)
+{
+  while (self->fim != NULL && self->usado + necessario > self->orcamento) {
+    remove_entrada(self, self->fim);
+    self->descartes++;
+  }
+}
+
+void cache_prog_destroi(cache_prog_t *self)
+{
+  while (self->inicio != NULL) {
+    remove_entrada(self, self->inicio);
+  }
+  free(self);
+}
+
+void cache_prog_define_orcamento(cache_prog_t *self, size_t orcamento)
+{
+  self->orcamento = orcamento;
+  libera_espaco(self, 0);
+}
+
+// ACESSO
+
+static entrada_t *procura(cache_prog_t *self, char *nome)
+{
+  for (entrada_t *e = self->inicio; e != NULL; e = e->proxima) {
+    if (strcmp(e->nome, nome) == 0) return e;
+  }
+  return NULL;
+}
+
+static bool atualizada(entrada_t *e, struct stat *st)
+{
+  return e->modificacao.tv_sec == st->st_mtim.tv_sec
+      && e->modificacao.tv_nsec == st->st_mtim.tv_nsec
+      && e->tam_arquivo == st->st_size;
+}
+
+programa_t *cache_prog_pega(cache_prog_t *self, char *nome)
+{
+  struct stat st;
+  if (stat(nome, &st) != 0) return NULL;
+
+  entrada_t *e = procura(self, nome);
+  if (e != NULL) {
+    if (atualizada(e, &st)) {
+      self->acertos++;
+      tira_da_lista(self, e);
+      poe_no_inicio(self, e);
+      return e->prog;
+    }
+    remove_entrada(self, e);
+    self->desatualizadas++;
+  }
+
+  self->faltas++;
+  programa_t *prog = prog_cria(nome);
+  if (prog == NULL) return NULL;
+  size_t memoria = prog_memoria(prog);
+  if (memoria > self->orcamento) return prog;
+  libera_espaco(self, memoria);
+
+  e = malloc(sizeof(*e));
+  assert(e != NULL);
+  e->nome = strdup(nome);
+  assert(e->nome != NULL);
+  e->modificacao = st.st_mtim;
+  e->tam_arquivo = st.st_size;
+  e->prog = prog;
+  e->memoria = memoria;
+  poe_no_inicio(self, e);
+  self->usado += memoria;
+  return prog;
+}
+
+void cache_prog_devolve(cache_prog_t *self, programa_t *prog)
+{
+  // o programa pego por último, se está na cache, é o do início
+  if (self->inicio != NULL && self->inicio->prog == prog) return;
+  prog_destroi(prog);
+}
+
+void cache_prog_concatena_estatisticas(cache_prog_t *self, char *str, int tam)
+{
+  int n = strlen(str);
+  snprintf(str + n, tam - n, "cache de programas: %ld acertos, %ld faltas,"
+           " %ld descartes, %ld desatualizadas, %zu/%zu bytes",
+           self->acertos, self->faltas, self->descartes, self->desatualizadas,
+           self->usado, self->orcamento);
+}
@@ -0,0 +1,48 @@
+// cache_prog.h
+// cache de programas já lidos, para o carregador do SO
+// simulador de computador
+// so24b
+
+#ifndef CACHE_PROG_H
+#define CACHE_PROG_H
+
+// Guarda os programas lidos de arquivos (o programa_t, já interpretado ou
+//   mapeado), para que a carga do mesmo programa outras vezes não precise
+//   ler o arquivo de novo.
+// Uma entrada é identificada pelo nome do arquivo e pela data de modificação
+//   (e tamanho) dele; se o arquivo for alterado, a entrada é descartada e o
+//   arquivo é lido de novo.
+// A cache tem um orçamento de memória (em bytes, medido por prog_memoria);
+//   quando uma entrada nova não cabe, são descartadas as menos recentemente
+//   usadas. Um programa maior que o orçamento não é guardado.
+
+#include "programa.h"
+
+#include <stddef.h>
+
+typedef struct cache_prog_t cache_prog_t;
+
+// cria uma cache com o orçamento de 'orcamento' bytes (0 desabilita a cache)
+cache_prog_t *cache_prog_cria(size_t orcamento);
+
+// destrói a cache e todos os programas que ela contém
+void cache_prog_destroi(cache_prog_t *self);
+
+// altera o orçamento, descartando entradas se necessário
+void cache_prog_define_orcamento(cache_prog_t *self, size_t orcamento);
+
+// retorna o programa do arquivo 'nome', da cache ou lido do arquivo
+// retorna NULL se o arquivo não puder ser lido
+// o programa retornado não pode ser destruído; deve ser devolvido com
+//   cache_prog_devolve antes da próxima chamada a cache_prog_pega
+programa_t *cache_prog_pega(cache_prog_t *self, char *nome);
+
+// devolve um programa obtido com cache_prog_pega (se ele não ficou na
+//   cache, é destruído)
+void cache_prog_devolve(cache_prog_t *self, programa_t *prog);
+
+// concatena em str os contadores da cache, sem que str passe de 'tam'
+//   caracteres (contando o '\0')
+void cache_prog_concatena_estatisticas(cache_prog_t *self, char *str, int tam);
+
+#endif // CACHE_PROG_H
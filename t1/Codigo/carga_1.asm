@@ -0,0 +1,37 @@
+; carga_1 -- gerado por gera_carga, carga em 11170
+; cria 0 processos, executa 8 rajadas de 100 voltas, escreve 'b' a cada 2 rajadas
+
+SO_ESCR        define 2
+SO_CRIA_PROC   define 7
+SO_MATA_PROC   define 8
+SO_ESPERA_PROC define 9
+
+         cargi  8
+         armm   rajadas
+         cargi  2
+         armm   cont_es
+rajada   cargi  100
+laco     sub    um
+         desvnz laco
+         cargm  cont_es
+         sub    um
+         armm   cont_es
+         desvnz sem_es
+         cargi  2
+         armm   cont_es
+         cargi  98
+         trax
+         cargi  SO_ESCR
+         chamas
+sem_es   cargm  rajadas
+         sub    um
+         armm   rajadas
+         desvnz rajada
+         cargi  0
+         trax
+         cargi  SO_MATA_PROC
+         chamas
+
+rajadas  espaco 1
+cont_es  espaco 1
+um       valor  1
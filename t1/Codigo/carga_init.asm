@@ -0,0 +1,453 @@
+; carga_init -- gerado por gera_carga, carga em 10000
+; cria 40 processos, executa 0 rajadas de 100 voltas
+
+SO_ESCR        define 2
+SO_CRIA_PROC   define 7
+SO_MATA_PROC   define 8
+SO_ESPERA_PROC define 9
+
+         cargi  nome_0
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_0
+         cargi  nome_1
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_1
+         cargi  nome_2
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_2
+         cargi  nome_3
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_3
+         cargi  nome_4
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_4
+         cargi  nome_5
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_5
+         cargi  nome_6
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_6
+         cargi  nome_7
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_7
+         cargi  nome_8
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_8
+         cargi  nome_9
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_9
+         cargi  nome_10
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_10
+         cargi  nome_11
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_11
+         cargi  nome_12
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_12
+         cargi  nome_13
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_13
+         cargi  nome_14
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_14
+         cargi  nome_15
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_15
+         cargi  nome_16
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_16
+         cargi  nome_17
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_17
+         cargi  nome_18
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_18
+         cargi  nome_19
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_19
+         cargi  nome_20
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_20
+         cargi  nome_21
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_21
+         cargi  nome_22
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_22
+         cargi  nome_23
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_23
+         cargi  nome_24
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_24
+         cargi  nome_25
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_25
+         cargi  nome_26
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_26
+         cargi  nome_27
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_27
+         cargi  nome_28
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_28
+         cargi  nome_29
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_29
+         cargi  nome_30
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_30
+         cargi  nome_31
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_31
+         cargi  nome_32
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_32
+         cargi  nome_33
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_33
+         cargi  nome_34
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_34
+         cargi  nome_35
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_35
+         cargi  nome_36
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_36
+         cargi  nome_37
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_37
+         cargi  nome_38
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_38
+         cargi  nome_39
+         trax
+         cargi  SO_CRIA_PROC
+         chamas
+         armm   pid_39
+         cargm  pid_0
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_1
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_2
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_3
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_4
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_5
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_6
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_7
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_8
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_9
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_10
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_11
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_12
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_13
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_14
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_15
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_16
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_17
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_18
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_19
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_20
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_21
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_22
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_23
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_24
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_25
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_26
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_27
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_28
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_29
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_30
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_31
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_32
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_33
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_34
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_35
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_36
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_37
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_38
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargm  pid_39
+         trax
+         cargi  SO_ESPERA_PROC
+         chamas
+         cargi  0
+         trax
+         cargi  SO_MATA_PROC
+         chamas
+
+pid_0    espaco 1
+nome_0   string 'carga_0.maq'
+pid_1    espaco 1
+nome_1   string 'carga_1.maq'
+pid_2    espaco 1
+nome_2   string 'carga_2.maq'
+pid_3    espaco 1
+nome_3   string 'carga_3.maq'
+pid_4    espaco 1
+nome_4   string 'carga_4.maq'
+pid_5    espaco 1
+nome_5   string 'carga_5.maq'
+pid_6    espaco 1
+nome_6   string 'carga_6.maq'
+pid_7    espaco 1
+nome_7   string 'carga_7.maq'
+pid_8    espaco 1
+nome_8   string 'carga_8.maq'
+pid_9    espaco 1
+nome_9   string 'carga_9.maq'
+pid_10   espaco 1
+nome_10  string 'carga_10.maq'
+pid_11   espaco 1
+nome_11  string 'carga_11.maq'
+pid_12   espaco 1
+nome_12  string 'carga_12.maq'
+pid_13   espaco 1
+nome_13  string 'carga_13.maq'
+pid_14   espaco 1
+nome_14  string 'carga_14.maq'
+pid_15   espaco 1
+nome_15  string 'carga_15.maq'
+pid_16   espaco 1
+nome_16  string 'carga_16.maq'
+pid_17   espaco 1
+nome_17  string 'carga_17.maq'
+pid_18   espaco 1
+nome_18  string 'carga_18.maq'
+pid_19   espaco 1
+nome_19  string 'carga_19.maq'
+pid_20   espaco 1
+nome_20  string 'carga_20.maq'
+pid_21   espaco 1
+nome_21  string 'carga_21.maq'
+pid_22   espaco 1
+nome_22  string 'carga_22.maq'
+pid_23   espaco 1
+nome_23  string 'carga_23.maq'
+pid_24   espaco 1
+nome_24  string 'carga_24.maq'
+pid_25   espaco 1
+nome_25  string 'carga_25.maq'
+pid_26   espaco 1
+nome_26  string 'carga_26.maq'
+pid_27   espaco 1
+nome_27  string 'carga_27.maq'
+pid_28   espaco 1
+nome_28  string 'carga_28.maq'
+pid_29   espaco 1
+nome_29  string 'carga_29.maq'
+pid_30   espaco 1
+nome_30  string 'carga_30.maq'
+pid_31   espaco 1
+nome_31  string 'carga_31.maq'
+pid_32   espaco 1
+nome_32  string 'carga_32.maq'
+pid_33   espaco 1
+nome_33  string 'carga_33.maq'
+pid_34   espaco 1
+nome_34  string 'carga_34.maq'
+pid_35   espaco 1
+nome_35  string 'carga_35.maq'
+pid_36   espaco 1
+nome_36  string 'carga_36.maq'
+pid_37   espaco 1
+nome_37  string 'carga_37.maq'
+pid_38   espaco 1
+nome_38  string 'carga_38.maq'
+pid_39   espaco 1
+nome_39  string 'carga_39.maq'
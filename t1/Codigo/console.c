@@ -8,12 +8,14 @@
 #include "console.h"
 #include "terminal.h"
 #include "tela.h"
+#include "registro.h"
 
 #include <string.h>
 #include <stdarg.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <time.h>
 #include <assert.h>
 
 // CONSTANTES {{{1
@@ -39,6 +41,17 @@
 // números de comandos para o controlador que podem ser guardados na console
 #define N_CMD_EXT 10
 
+// número de linhas que podem estar esperando para serem gravadas no log; se
+//   a gravação não der conta, as demais são descartadas
+#define N_LINHAS_LOG 4096
+
+// intervalo mínimo entre dois redesenhos da tela (~30 por segundo)
+#define MS_ENTRE_DESENHOS 33
+
+// instruções entre dois caracteres lidos de um arquivo de entrada, se não
+//   for definido outro ritmo
+#define RITMO_ENTRADA_PADRAO 100
+
 // DECLARAÇÃO {{{1
 
 struct console_t {
@@ -49,13 +62,42 @@ struct console_t {
   char txt_console[N_LIN_CONSOLE][N_COL+1];
   char txt_entrada[N_COL+1];
   char fila_de_comandos_externos[N_CMD_EXT];
-  FILE *arquivo_de_log;
+  registro_t *log;  // o que sai na console vai também para o arquivo de log
+  bool espera_no_fim;
+  // false se executa sem a tela (e sem teclado)
+  bool usa_tela;
+  // linhas da tela que mudaram desde o último desenho (bit 'l' para a linha l)
+  unsigned linhas_alteradas;
+  long ms_ultimo_desenho;
+  // se true, redesenha todas as linhas a cada vez, sem limite de frequência
+  bool redesenho_completo;
+  // arquivos de onde vem a entrada e para onde vai a saída de cada terminal
+  //   (NULL se não tem)
+  FILE *arq_entrada[N_TERM];
+  int ritmo_entrada[N_TERM];   // instruções entre dois caracteres
+  int espera_entrada[N_TERM];  // instruções até o próximo caractere
+  bool entrada_recusada[N_TERM]; // o terminal não aceitou o último caractere
+  FILE *arq_saida[N_TERM];
 };
 
 // CRIAÇÃO {{{1
 
+#define TODAS_AS_LINHAS ((1u << N_LIN) - 1)
+
+static void marca_linha(console_t *self, int linha)
+{
+  self->linhas_alteradas |= 1u << linha;
+}
+
+static long agora_ms(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
 static console_t *console_global; // gambiarra para simplificar o uso de prints na console
-console_t *console_cria(void)
+console_t *console_cria(bool usa_tela)
 {
   console_t *self = malloc(sizeof(*self));
   assert(self != NULL);
@@ -70,51 +112,159 @@ console_t *console_cria(void)
       self->cor_txt[t] = COR_TXT_IMPAR;
       self->cor_cursor[t] = COR_CURSOR_IMPAR;
     }
+    self->arq_entrada[t] = NULL;
+    self->entrada_recusada[t] = false;
+    self->arq_saida[t] = NULL;
   }
   for (int l = 0; l < N_LIN_CONSOLE; l++) {
     strcpy(self->txt_console[l], "");
   }
   strcpy(self->txt_entrada, "");
   self->fila_de_comandos_externos[0] = '\0';
-  self->arquivo_de_log = fopen("log_da_console", "w");
+  self->log = registro_cria("log_da_console", N_LINHAS_LOG);
+  self->espera_no_fim = true;
+  self->usa_tela = usa_tela;
+  self->linhas_alteradas = TODAS_AS_LINHAS;
+  self->ms_ultimo_desenho = 0;
+  self->redesenho_completo = false;
 
-  tela_init();
+  if (usa_tela) tela_init();
 
   return self;
 }
 
-static void console_desenha(console_t *self);
+static void console_desenha(console_t *self, bool agora);
 
 void console_destroi(console_t *self)
 {
-  console_desenha(self);
-  if (self->arquivo_de_log != NULL) fclose(self->arquivo_de_log);
-  tela_puts(COR_OCUPADO, "  digite ENTER para sair  ");
-  tela_atualiza();
-  while (tela_tecla() != '\n') {
-    ;
+  // grava o que falta no log antes de desenhar a tela final
+  if (self->log != NULL) {
+    long descartadas = registro_descartadas(self->log);
+    registro_destroi(self->log);
+    self->log = NULL;
+    if (descartadas > 0) {
+      console_printf("log: %ld linhas descartadas", descartadas);
+    }
+  }
+  console_desenha(self, true);
+  if (self->usa_tela) {
+    if (self->espera_no_fim) {
+      tela_puts(COR_OCUPADO, "  digite ENTER para sair  ");
+      tela_atualiza();
+      while (tela_tecla() != '\n') {
+        ;
+      }
+    }
+    tela_fim();
   }
-  tela_fim();
 
   for (int t = 0; t < N_TERM; t++) {
+    if (self->arq_entrada[t] != NULL) fclose(self->arq_entrada[t]);
+    if (self->arq_saida[t] != NULL) fclose(self->arq_saida[t]);
     terminal_destroi(self->term[t]);
   }
   free(self);
   return;
 }
 
+void console_define_espera_no_fim(console_t *self, bool espera)
+{
+  self->espera_no_fim = espera;
+}
+
+void console_define_espera_teclado(console_t *self, int ms)
+{
+  if (self->usa_tela) tela_espera(ms);
+}
+
+void console_define_redesenho_completo(console_t *self, bool completo)
+{
+  self->redesenho_completo = completo;
+}
+
 // TERMINAIS {{{1
 
+static int num_terminal(char id_terminal)
+{
+  int num = tolower(id_terminal) - 'a';
+  if (num < 0 || num >= N_TERM) return -1;
+  return num;
+}
+
 terminal_t *console_terminal(console_t *self, char id_terminal)
 {
-  int num_terminal = tolower(id_terminal) - 'a';
-  if (num_terminal < 0 || num_terminal >= N_TERM) return NULL;
-  return self->term[num_terminal];
+  int t = num_terminal(id_terminal);
+  if (t < 0) return NULL;
+  return self->term[t];
+}
+
+bool console_entrada_de_arquivo(console_t *self, char id_terminal,
+                                char *nome, int ritmo)
+{
+  int t = num_terminal(id_terminal);
+  if (t < 0) return false;
+  FILE *arq = fopen(nome, "r");
+  if (arq == NULL) return false;
+  if (self->arq_entrada[t] != NULL) fclose(self->arq_entrada[t]);
+  if (ritmo <= 0) ritmo = RITMO_ENTRADA_PADRAO;
+  self->arq_entrada[t] = arq;
+  self->ritmo_entrada[t] = ritmo;
+  self->espera_entrada[t] = ritmo;
+  self->entrada_recusada[t] = false;
+  return true;
+}
+
+bool console_saida_para_arquivo(console_t *self, char id_terminal, char *nome)
+{
+  int t = num_terminal(id_terminal);
+  if (t < 0) return false;
+  FILE *arq = fopen(nome, "w");
+  if (arq == NULL) return false;
+  if (self->arq_saida[t] != NULL) fclose(self->arq_saida[t]);
+  self->arq_saida[t] = arq;
+  terminal_define_arquivo_saida(self->term[t], arq);
+  return true;
+}
+
+bool console_tem_entrada_pendente(console_t *self)
+{
+  for (int t = 0; t < N_TERM; t++) {
+    // um caractere recusado só entra se a CPU ler o terminal; se ela estiver
+    //   parada, isso não vai acontecer
+    if (self->arq_entrada[t] != NULL && !self->entrada_recusada[t]) return true;
+  }
+  return false;
+}
+
+// passa o próximo caractere do arquivo de entrada para o terminal, quando
+//   chega a hora
+// se o terminal não aceita (a entrada está cheia), o caractere volta para o
+//   arquivo e é tentado de novo na próxima instrução; no fim do arquivo, ele
+//   é fechado
+static void alimenta_terminal(console_t *self, int t)
+{
+  if (--self->espera_entrada[t] > 0) return;
+  FILE *arq = self->arq_entrada[t];
+  int ch = fgetc(arq);
+  if (ch == EOF) {
+    fclose(arq);
+    self->arq_entrada[t] = NULL;
+    return;
+  }
+  if (terminal_insere_char(self->term[t], ch)) {
+    self->espera_entrada[t] = self->ritmo_entrada[t];
+    self->entrada_recusada[t] = false;
+  } else {
+    ungetc(ch, arq);
+    self->espera_entrada[t] = 1;
+    self->entrada_recusada[t] = true;
+  }
 }
 
 static void atualiza_terminais(console_t *self)
 {
   for (int t = 0; t < N_TERM; t++) {
+    if (self->arq_entrada[t] != NULL) alimenta_terminal(self, t);
     terminal_tictac(self->term[t]);
   }
 }
@@ -155,9 +305,13 @@ static void insere_string_na_console(console_t *self, char *s)
   }
   strncpy(self->txt_console[N_LIN_CONSOLE-1], s, N_COL);
   self->txt_console[N_LIN_CONSOLE-1][N_COL] = '\0'; // grrrr
-  if (self->arquivo_de_log != NULL) {
-    fprintf(self->arquivo_de_log, "%s\n", s);
+  // todas as linhas da console rolaram
+  for (int l = 0; l < N_LIN_CONSOLE; l++) {
+    marca_linha(self, LINHA_CONSOLE + l);
   }
+  if (self->log != NULL) registro_escreve(self->log, s);
+  // sem a tela, as mensagens vão para a saída padrão
+  if (!self->usa_tela) printf("%s\n", s);
 }
 
 static void insere_strings_na_console(console_t *self, char *s)
@@ -178,7 +332,11 @@ static void insere_strings_na_console(console_t *self, char *s)
 void console_print_status(console_t *self, char *txt)
 {
   // imprime alinhado a esquerda ("-"), max N_COL chars ("*")
-  sprintf(self->txt_status, "%-*s", N_COL, txt);
+  char novo[N_COL+1];
+  snprintf(novo, sizeof(novo), "%-*s", N_COL, txt);
+  if (strcmp(novo, self->txt_status) == 0) return;
+  strcpy(self->txt_status, novo);
+  marca_linha(self, LINHA_STATUS);
 }
 
 int console_printf(char *formato, ...)
@@ -258,7 +416,10 @@ static void interpreta_linha_entrada(console_t *self)
 // lê e guarda um caractere do teclado; interpreta linha se for 'enter'
 static void verifica_entrada(console_t *self)
 {
+  if (!self->usa_tela) return;
   char ch = tela_tecla();
+  if (ch == 0) return;
+  marca_linha(self, LINHA_ENTRADA);
 
   int l = strlen(self->txt_entrada);
 
@@ -282,6 +443,13 @@ char console_comando_externo(console_t *self)
 
 // DESENHO {{{1
 
+// só as linhas alteradas desde o último desenho são reescritas na tela
+
+static bool linha_alterada(console_t *self, int linha)
+{
+  return (self->linhas_alteradas & (1u << linha)) != 0;
+}
+
 static void desenha_linha_terminal(char *txt, int linha, int cor_txt, int cor_cursor)
 {
   tela_posiciona(linha, 0);
@@ -297,13 +465,18 @@ static void desenha_terminais(console_t *self)
     int cor_txt = self->cor_txt[t];
     int cor_cursor = self->cor_cursor[t];
     int linha = LINHA_TERM + t * 2;
-    desenha_linha_terminal(terminal_txt_entrada(terminal), linha, cor_txt, cor_cursor);
-    desenha_linha_terminal(terminal_txt_saida(terminal), linha+1, cor_txt, cor_cursor);
+    if (terminal_entrada_alterada(terminal) || linha_alterada(self, linha)) {
+      desenha_linha_terminal(terminal_txt_entrada(terminal), linha, cor_txt, cor_cursor);
+    }
+    if (terminal_saida_alterada(terminal) || linha_alterada(self, linha+1)) {
+      desenha_linha_terminal(terminal_txt_saida(terminal), linha+1, cor_txt, cor_cursor);
+    }
   }
 }
 
 static void desenha_status(console_t *self)
 {
+  if (!linha_alterada(self, LINHA_STATUS)) return;
   tela_posiciona(LINHA_STATUS, 0);
   tela_puts(COR_STATUS, self->txt_status);
   tela_limpa_linha();
@@ -312,6 +485,7 @@ static void desenha_status(console_t *self)
 static void desenha_console(console_t *self)
 {
   for (int l=0; l<N_LIN_CONSOLE; l++) {
+    if (!linha_alterada(self, LINHA_CONSOLE + l)) continue;
     tela_posiciona(LINHA_CONSOLE + l, 0);
     tela_puts(COR_CONSOLE, self->txt_console[l]);
     tela_limpa_linha();
@@ -320,6 +494,7 @@ static void desenha_console(console_t *self)
 
 static void desenha_entrada(console_t *self)
 {
+  if (!linha_alterada(self, LINHA_ENTRADA)) return;
   char txt_fixo[] = "P=para C=continua 1=passo F=fim  Ets=entra Zt=zera";
   tela_posiciona(LINHA_ENTRADA, 0);
   tela_puts(COR_ENTRADA, ""); // gambiarra para limpar na cor certa
@@ -330,8 +505,18 @@ static void desenha_entrada(console_t *self)
   tela_puts(COR_ENTRADA, self->txt_entrada);
 }
 
-static void console_desenha(console_t *self)
+// redesenha as linhas alteradas, se já passou tempo suficiente desde o
+//   último desenho (ou se 'agora' for true)
+static void console_desenha(console_t *self, bool agora)
 {
+  if (!self->usa_tela) return;
+  if (self->redesenho_completo) {
+    self->linhas_alteradas = TODAS_AS_LINHAS;
+  } else if (!agora) {
+    long ms = agora_ms();
+    if (ms - self->ms_ultimo_desenho < MS_ENTRE_DESENHOS) return;
+    self->ms_ultimo_desenho = ms;
+  }
   desenha_terminais(self);
   desenha_status(self);
   desenha_console(self);
@@ -339,6 +524,12 @@ static void console_desenha(console_t *self)
 
   // faz aparecer tudo que foi desenhado
   tela_atualiza();
+  self->linhas_alteradas = 0;
+}
+
+void console_redesenha(console_t *self)
+{
+  console_desenha(self, false);
 }
 
 // TICTAC {{{1
@@ -346,7 +537,12 @@ void console_tictac(console_t *self)
 {
   verifica_entrada(self);
   atualiza_terminais(self);
-  console_desenha(self);
+  console_desenha(self, false);
+}
+
+void console_tictac_terminais(console_t *self)
+{
+  atualiza_terminais(self);
 }
 
 // vim: foldmethod=marker
@@ -12,7 +12,10 @@
 typedef struct console_t console_t;
 
 // cria e inicializa a console
-console_t *console_cria(void);
+// se 'usa_tela' for false, a console não usa a tela nem o teclado: as
+//   mensagens vão para a saída padrão (além do arquivo de log), e os
+//   terminais só têm entrada e saída por arquivo (ver abaixo)
+console_t *console_cria(bool usa_tela);
 
 // destrói a console
 void console_destroi(console_t *self);
@@ -37,7 +40,46 @@ char console_comando_externo(console_t *self);
 // retorna o terminal identificado ('A', 'B', etc)
 terminal_t *console_terminal(console_t *self, char id_terminal);
 
+// liga a entrada do terminal 't' ao arquivo 'nome' (que pode ser um pipe):
+//   um caractere do arquivo é digitado no terminal a cada 'ritmo' instruções
+//   (ou a cada 100, se ritmo não for positivo), ou assim que couber, se a
+//   entrada do terminal estiver cheia. O ritmo é contado em instruções e
+//   não em tempo real, para a execução ser reproduzível; se o arquivo for um
+//   pipe, a simulação espera pelo próximo caractere.
+// no fim do arquivo, a entrada volta a ser só pelo comando E do operador
+// retorna false se o terminal não existe ou o arquivo não pode ser aberto
+bool console_entrada_de_arquivo(console_t *self, char id_terminal,
+                                char *nome, int ritmo);
+
+// grava no arquivo 'nome' tudo que for escrito na saída do terminal 't'
+// retorna false se o terminal não existe ou o arquivo não pode ser criado
+bool console_saida_para_arquivo(console_t *self, char id_terminal, char *nome);
+
+// retorna true se algum terminal ainda tem caracteres a receber de arquivo
+//   (não conta o terminal cuja entrada está cheia, esperando ser lida)
+bool console_tem_entrada_pendente(console_t *self);
+
 // esta função deve ser chamada periodicamente para que tela funcione
+// a tela é redesenhada no máximo ~30 vezes por segundo, e só as linhas que
+//   mudaram são reescritas
 void console_tictac(console_t *self);
 
+// partes de console_tictac, para quem não quer redesenhar a tela a cada vez:
+// avança o estado dos terminais (deve ser chamada a cada instrução executada)
+void console_tictac_terminais(console_t *self);
+// redesenha a tela (com o mesmo limite de frequência)
+void console_redesenha(console_t *self);
+
+// define se console_destroi espera o operador digitar ENTER antes de
+//   terminar (o padrão é esperar)
+void console_define_espera_no_fim(console_t *self, bool espera);
+
+// define quanto tempo (em ms) a leitura do teclado espera por uma tecla
+//   (o comando D do operador faz o mesmo)
+void console_define_espera_teclado(console_t *self, int ms);
+
+// se 'completo' for true, toda a tela é redesenhada a cada chamada, sem limite
+//   de frequência, como era antes (para comparar o custo do desenho)
+void console_define_redesenho_completo(console_t *self, bool completo);
+
 #endif // CONSOLE_H
@@ -8,21 +8,47 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdbool.h>
+#include <time.h>
 #include <assert.h>
 
+// no modo em lote, de quantas em quantas instruções consulta o relógio real
+//   para ver se está na hora de atualizar a console
+#define INSTRUCOES_ENTRE_CONSULTAS 1024
+// no modo em lote, número máximo de instruções executadas de uma vez
+#define MAX_INSTRUCOES_DE_UMA_VEZ INSTRUCOES_ENTRE_CONSULTAS
+// no modo em lote, intervalo máximo (em ms) entre consultas aos comandos do
+//   operador, mesmo que a tela não esteja sendo redesenhada
+#define MS_ENTRE_COMANDOS 100
+
 struct controle_t {
   cpu_t *cpu;
   relogio_t *relogio;
   console_t *console;
+  pic_t *pic;
   enum { executando, passo, parado, fim } estado;
+  // modo em lote: a console não é atualizada a cada instrução
+  bool em_lote;
+  int atualiza_a_cada_instrucoes; // 0 para não usar esse critério
+  int atualiza_a_cada_ms;         // 0 para não usar esse critério
+  int instrucoes_desde_atualizacao;
+  int instrucoes_desde_consulta;
+  long ms_ultima_atualizacao;
+  long ms_ultimo_comando;
+  // instruções efetivamente executadas (o relógio avança também com a CPU
+  //   parada)
+  long instrucoes_executadas;
 };
 
 // funções auxiliares
+static int controle_executa(controle_t *self);
+static void controle_tictac_em_lote(controle_t *self, int passos);
 static void controle_processa_comandos_da_console(controle_t *self);
 static void controle_atualiza_estado_na_console(controle_t *self);
 
 
-controle_t *controle_cria(cpu_t *cpu, console_t *console, relogio_t *relogio)
+controle_t *controle_cria(cpu_t *cpu, console_t *console, relogio_t *relogio,
+                          pic_t *pic)
 {
   controle_t *self = malloc(sizeof(*self));
   assert(self != NULL);
@@ -30,7 +56,10 @@ controle_t *controle_cria(cpu_t *cpu, console_t *console, relogio_t *relogio)
   self->cpu = cpu;
   self->console = console;
   self->relogio = relogio;
+  self->pic = pic;
   self->estado = parado;
+  self->em_lote = false;
+  self->instrucoes_executadas = 0;
 
   return self;
 }
@@ -40,34 +69,187 @@ void controle_destroi(controle_t *self)
   free(self);
 }
 
+// retorna o tempo real, em ms
+static long agora_ms(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+void controle_define_lote(controle_t *self, int n_instrucoes, int ms)
+{
+  self->em_lote = true;
+  self->atualiza_a_cada_instrucoes = n_instrucoes;
+  self->atualiza_a_cada_ms = ms;
+  self->instrucoes_desde_atualizacao = 0;
+  self->instrucoes_desde_consulta = 0;
+  self->ms_ultima_atualizacao = agora_ms();
+  self->ms_ultimo_comando = self->ms_ultima_atualizacao;
+  // em lote não tem ninguém para mandar começar
+  self->estado = executando;
+}
+
 void controle_laco(controle_t *self)
 {
-  // executa uma instrução por vez até a console dizer que chega
+  // executa instruções até a console dizer que chega
   do {
+    int passos = 0;
     if (self->estado == passo || self->estado == executando) {
-      cpu_executa_1(self->cpu);
-      relogio_tictac(self->relogio);
-
-      if (self->estado == passo) self->estado = parado;
-
-      // enquanto não tem controlador de interrupção, fala direto com o relógio
-      // o dispositivo 3 do relógio contém 1 se o timer expirou
-      int tem_int;
-      relogio_leitura(self->relogio, 3, &tem_int);
-      if (tem_int != 0) {
-        cpu_interrompe(self->cpu, IRQ_RELOGIO);
-      }
+      passos = controle_executa(self);
     }
-    console_tictac(self->console);
+    if (self->em_lote && self->estado == executando) {
+      controle_tictac_em_lote(self, passos);
+    } else {
+      console_tictac(self->console);
 
-    controle_processa_comandos_da_console(self);
-    controle_atualiza_estado_na_console(self);
+      controle_processa_comandos_da_console(self);
+      controle_atualiza_estado_na_console(self);
+    }
   } while (self->estado != fim);
 
   console_printf("Fim da execução.");
   console_printf("relógio: %d\n", relogio_agora(self->relogio));
+  console_printf("instruções executadas: %ld", self->instrucoes_executadas);
+  char estatisticas[200] = "";
+  cpu_concatena_estatisticas(self->cpu, estatisticas, sizeof(estatisticas));
+  if (estatisticas[0] != '\0') console_printf("%s", estatisticas);
+  estatisticas[0] = '\0';
+  pic_concatena_estatisticas(self->pic, estatisticas, sizeof(estatisticas));
+  console_printf("%s", estatisticas);
+}
+
+// quantas instruções podem ser executadas de uma vez
+// fora do modo em lote, a console é atualizada a cada instrução, então é uma
+//   só; em lote, executa até o timer expirar ou até a próxima atualização
+static int controle_orcamento(controle_t *self)
+{
+  if (!self->em_lote || self->estado == passo) return 1;
+  int n = MAX_INSTRUCOES_DE_UMA_VEZ;
+  // o dispositivo 2 do relógio contém o número de instruções até o timer
+  //   expirar (0 se não está programado)
+  int timer;
+  relogio_leitura(self->relogio, 2, &timer);
+  if (timer > 0 && timer < n) n = timer;
+  if (self->atualiza_a_cada_instrucoes > 0) {
+    int falta = self->atualiza_a_cada_instrucoes - self->instrucoes_desde_atualizacao;
+    if (falta > 0 && falta < n) n = falta;
+  }
+  return n;
+}
+
+// se o controlador de interrupções tem alguma pendente, tenta entregar a de
+//   maior prioridade à CPU (que só aceita em modo usuário ou parada; se não
+//   aceitar, continua pendente)
+static void controle_entrega_interrupcao(controle_t *self)
+{
+  if (!pic_tem_pendente(self->pic)) return;
+  int irq = pic_proxima(self->pic);
+  if (cpu_interrompe(self->cpu, irq)) {
+    pic_reconhece(self->pic, irq);
+  }
+}
+
+// em lote, os terminais avançam uma vez por instrução, como no modo normal
+//   (fora do lote, console_tictac faz isso)
+static void controle_avanca_terminais(controle_t *self, int passos)
+{
+  for (int i = 0; i < passos; i++) {
+    console_tictac_terminais(self->console);
+  }
+}
+
+// com a CPU parada, deixa passar até 'n' unidades de tempo (o orçamento já
+//   para no timer); em lote, os terminais avançam antes do relógio, e a espera
+//   termina na unidade em que algum deles pede uma interrupção, para que ela
+//   seja entregue na hora certa e não só no fim do salto
+// retorna o número de unidades de tempo que passaram
+static int controle_espera_parada(controle_t *self, int n)
+{
+  if (!self->em_lote) return n;
+  bool ja_pendente = pic_tem_pendente(self->pic);
+  for (int i = 1; i <= n; i++) {
+    console_tictac_terminais(self->console);
+    if (!ja_pendente && pic_tem_pendente(self->pic)) return i;
+  }
+  return n;
+}
+
+// executa um lote de instruções e avança o relógio de acordo
+// retorna o número de unidades de tempo que passaram
+static int controle_executa(controle_t *self)
+{
+  controle_entrega_interrupcao(self);
+  int n = controle_orcamento(self);
+  int passos = cpu_executa_n(self->cpu, n);
+  self->instrucoes_executadas += passos;
+  if (passos == 0) {
+    // com a CPU parada, o tempo passa do mesmo jeito, até uma interrupção
+    passos = controle_espera_parada(self, n);
+  } else if (self->em_lote) {
+    controle_avanca_terminais(self, passos);
+  }
+  relogio_avanca(self->relogio, passos);
+
+  if (self->estado == passo) self->estado = parado;
+
+  return passos;
+}
+
+// retorna true se a CPU está parada e nada mais pode acordá-la
+// (em lote ninguém digita nos terminais; além do relógio, só a entrada dos
+//   terminais vinda de arquivo pode gerar uma interrupção no futuro)
+static bool controle_maquina_morta(controle_t *self)
+{
+  if (!cpu_parada(self->cpu)) return false;
+  if (console_tem_entrada_pendente(self->console)) return false;
+  int timer;
+  relogio_leitura(self->relogio, 2, &timer);
+  return timer == 0 && !pic_tem_pendente(self->pic);
+}
+
+// chamada depois de cada lote de instruções no modo em lote, no lugar de
+//   console_tictac
+// os terminais já avançaram em controle_executa; a tela só é redesenhada e os
+//   comandos só são lidos de tempos em tempos
+static void controle_tictac_em_lote(controle_t *self, int passos)
+{
+  if (controle_maquina_morta(self)) {
+    self->estado = fim;
+    controle_atualiza_estado_na_console(self);
+    return;
+  }
+
+  self->instrucoes_desde_atualizacao += passos;
+  self->instrucoes_desde_consulta += passos;
+  bool atualiza = false;
+  bool le_comandos = false;
+  if (self->atualiza_a_cada_instrucoes > 0
+      && self->instrucoes_desde_atualizacao >= self->atualiza_a_cada_instrucoes) {
+    atualiza = true;
+  } else if (self->instrucoes_desde_consulta >= INSTRUCOES_ENTRE_CONSULTAS) {
+    self->instrucoes_desde_consulta = 0;
+    long agora = agora_ms();
+    if (self->atualiza_a_cada_ms > 0
+        && agora - self->ms_ultima_atualizacao >= self->atualiza_a_cada_ms) {
+      atualiza = true;
+    } else if (agora - self->ms_ultimo_comando >= MS_ENTRE_COMANDOS) {
+      le_comandos = true;
+    }
+  }
+
+  if (atualiza) {
+    self->instrucoes_desde_atualizacao = 0;
+    self->ms_ultima_atualizacao = agora_ms();
+    controle_atualiza_estado_na_console(self);
+    console_redesenha(self->console);
+    le_comandos = true;
+  }
+  if (le_comandos) {
+    self->ms_ultimo_comando = agora_ms();
+    controle_processa_comandos_da_console(self);
+  }
 }
- 
 
 static void controle_processa_comandos_da_console(controle_t *self)
 {
@@ -11,10 +11,23 @@ typedef struct controle_t controle_t;
 #include "cpu.h"
 #include "console.h"
 #include "relogio.h"
+#include "pic.h"
 
-controle_t *controle_cria(cpu_t *cpu, console_t *console, relogio_t *relogio);
+// as interrupções dos dispositivos são entregues à CPU pelo controlador de
+//   interrupções 'pic', consultado antes de cada lote de instruções
+controle_t *controle_cria(cpu_t *cpu, console_t *console, relogio_t *relogio,
+                          pic_t *pic);
 void controle_destroi(controle_t *self);
 
+// coloca o controlador em modo em lote: a CPU executa sem parar desde o início,
+//   e a console só é redesenhada a cada 'n_instrucoes' instruções ou a cada 'ms'
+//   milissegundos de tempo real (0 desliga o critério correspondente; com os
+//   dois em 0 a tela não é redesenhada durante a execução)
+// os comandos do operador (P, C, 1, F) continuam sendo atendidos, e a
+//   simulação termina sozinha quando a CPU para e o relógio não tem mais como
+//   gerar interrupção
+void controle_define_lote(controle_t *self, int n_instrucoes, int ms);
+
 // o laço principal da simulação
 void controle_laco(controle_t *self);
 
@@ -7,6 +7,7 @@
 #include "cpu.h"
 #include "err.h"
 #include "instrucao.h"
+#include "blocos.h"
 
 #include <stdbool.h>
 #include <stdlib.h>
@@ -15,6 +16,13 @@
 #include <assert.h>
 
 // DECLARAÇÃO {{{1
+// uma instrução pré-decodificada, para o motor encadeado
+typedef struct {
+  void *rotulo;       // código que implementa a instrução (NULL se não decodificada)
+  int A1;             // argumento da instrução, já lido da memória
+  bool privilegiada;  // se a instrução só pode ser executada em modo supervisor
+} decod_t;
+
 // uma CPU tem estado, memória, controlador de ES
 struct cpu_t {
   // registradores
@@ -33,6 +41,17 @@ struct cpu_t {
   // função e argumento para implementar instrução CHAMAC
   func_chamaC_t funcaoC;
   void *argC;
+  // motor de execução e, para o motor encadeado, a memória pré-decodificada
+  //   (uma entrada por endereço de memória)
+  cpu_motor_t motor;
+  decod_t *decod;
+  int tam_decod;
+  // para o motor de blocos, a cache de blocos traduzidos, e se o bloco em
+  //   execução foi invalidado por uma escrita na memória
+  blocos_t *blocos;
+  bool abandona_bloco;
+  // número de superinstruções executadas inteiras
+  long superinstrucoes;
 };
 
 // CRIAÇÃO {{{1
@@ -52,6 +71,12 @@ cpu_t *cpu_cria(mem_t *mem, es_t *es)
   self->complemento = 0;
   self->modo = usuario;
   self->funcaoC = NULL;
+  self->motor = CPU_MOTOR_SWITCH;
+  self->decod = NULL;
+  self->tam_decod = 0;
+  self->blocos = NULL;
+  self->abandona_bloco = false;
+  self->superinstrucoes = 0;
   // inicializa instruções privilegiadas
   memset(self->privilegiadas, 0, sizeof(self->privilegiadas));
   self->privilegiadas[PARA] = true;
@@ -68,9 +93,46 @@ cpu_t *cpu_cria(mem_t *mem, es_t *es)
 void cpu_destroi(cpu_t *self)
 {
   // eu nao criei memória nem es; quem criou que destrua!
+  if (self->decod != NULL || self->blocos != NULL) {
+    mem_define_observador(self->mem, NULL, NULL);
+  }
+  free(self->decod);
+  if (self->blocos != NULL) blocos_destroi(self->blocos);
   free(self);
 }
 
+// chamada pela memória a cada escrita, para descartar o que foi
+//   pré-decodificado ou traduzido a partir do valor antigo
+static void cpu_observa_escrita(void *arg, int endereco)
+{
+  cpu_t *self = arg;
+  if (self->decod != NULL) {
+    // a escrita pode ter alterado o opcode da instrução em 'endereco' ou o
+    //   argumento da instrução em 'endereco - 1'
+    self->decod[endereco].rotulo = NULL;
+    if (endereco > 0) self->decod[endereco - 1].rotulo = NULL;
+  }
+  if (self->blocos != NULL && blocos_invalida(self->blocos, endereco)) {
+    self->abandona_bloco = true;
+  }
+}
+
+void cpu_define_motor(cpu_t *self, cpu_motor_t motor)
+{
+  self->motor = motor;
+  if (motor == CPU_MOTOR_ENCADEADO && self->decod == NULL) {
+    self->tam_decod = mem_tam(self->mem);
+    self->decod = calloc(self->tam_decod, sizeof(*self->decod));
+    assert(self->decod != NULL);
+  }
+  if (motor == CPU_MOTOR_BLOCOS && self->blocos == NULL) {
+    self->blocos = blocos_cria(self->mem);
+  }
+  if (self->decod != NULL || self->blocos != NULL) {
+    mem_define_observador(self->mem, cpu_observa_escrita, self);
+  }
+}
+
 void cpu_define_chamaC(cpu_t *self, func_chamaC_t funcaoC, void *argC)
 {
   self->funcaoC = funcaoC;
@@ -126,6 +188,16 @@ void cpu_concatena_descricao(cpu_t *self, char *str)
   strcat(str, aux);
 }
 
+void cpu_concatena_estatisticas(cpu_t *self, char *str, int tam)
+{
+  if (self->blocos != NULL) blocos_concatena_estatisticas(self->blocos, str, tam);
+  if (self->superinstrucoes > 0) {
+    int n = strlen(str);
+    snprintf(str + n, tam - n, "%ssuperinstruções: %ld", n == 0 ? "" : "; ",
+             self->superinstrucoes);
+  }
+}
+
 // ACESSO À MEMÓRIA E E/S {{{1
 
 // ---------------------------------------------------------------------
@@ -459,33 +531,489 @@ static void executa_a_instrucao(cpu_t *self, int opcode)
     case RETI:   op_RETI(self);   break;
     case CHAMAC: op_CHAMAC(self); break;
     case CHAMAS: op_CHAMAS(self); break;
+    // uma superinstrução executada sozinha é a sua primeira instrução
+    case TRAX_ARMM_CARGI_CHAMAS:
+    case CARGM_SUB_DESVZ:
+    case TRAX_CARGM_TRAX_RET:
+      executa_a_instrucao(self, instrucao_componente(opcode, 0));
+      break;
     default:     self->erro = ERR_INSTR_INV;
   }
 }
 
-void cpu_executa_1(cpu_t *self)
+// executa a superinstrução 'opcode', que está no PC
+// executa toda a sequência que ela representa, se couber em 'max' instruções
+//   e a CPU estiver em modo usuário, senão só a primeira instrução; para no
+//   meio da sequência, no mesmo ponto em que pararia executando as instruções
+//   separadas, se houver erro ou se a CPU sair do modo usuário
+// o programa pode ter alterado o resto da sequência (código automodificável):
+//   antes de cada instrução depois da primeira, confere se o opcode na memória
+//   ainda é o esperado; se não for, para ali, e a próxima execução lê o que
+//   está lá
+// retorna o número de instruções executadas
+static int executa_superinstrucao(cpu_t *self, int opcode, int max)
 {
-  // não executa se CPU já estiver em erro
-  if (self->erro != ERR_OK) return;
+  int n = instrucao_num_componentes(opcode);
+  if (n > max || self->modo != usuario) n = 1;
+  int executadas = 0;
+  while (executadas < n) {
+    int componente = instrucao_componente(opcode, executadas);
+    if (executadas > 0) {
+      int na_memoria;
+      if (mem_le(self->mem, self->PC, &na_memoria) != ERR_OK
+          || na_memoria != componente) {
+        break;
+      }
+    }
+    executa_a_instrucao(self, componente);
+    executadas++;
+    if (self->erro != ERR_OK || self->modo != usuario) break;
+  }
+  if (executadas > 1) self->superinstrucoes++;
+  return executadas;
+}
+
+// se a CPU entrou em erro, causa uma interrupção
+// a menos que a CPU tenha parado, porque a única forma de a CPU entrar nesse
+//   estado é pela execução da instrução PARA em modo supervisor, e é a forma de
+//   o SO dizer que não tem mais nada para fazer, e deve-se deixar a CPU dormindo
+//   até que venha uma interrupção de E/S
+static void cpu_verifica_erro(cpu_t *self)
+{
+  if (self->erro != ERR_OK && self->erro != ERR_CPU_PARADA) {
+    // se a interrupção não é aceita nesse ponto, temos um problema grave...
+    assert(cpu_interrompe(self, IRQ_ERR_CPU));
+  }
+}
 
+// executa uma instrução com o motor de referência
+static void executa_1_switch(cpu_t *self)
+{
   int opcode;
   if (pega_opcode(self, &opcode)) {
     executa_a_instrucao(self, opcode);
   }
+  cpu_verifica_erro(self);
+}
 
-  // se a CPU entrou em erro, causa uma interrupção
-  // a menos que a CPU tenha parado, porque a única forma de a CPU entrar nesse
-  //   estado é pela execução da instrução PARA em modo supervisor, e é a forma de
-  //   o SO dizer que não tem mais nada para fazer, e deve-se deixar a CPU dormindo
-  //   até que venha uma interrupção de E/S
-  if (self->erro != ERR_OK && self->erro != ERR_CPU_PARADA) {
-    // se a interrupção não é aceita nesse ponto, temos um problema grave...
-    assert(cpu_interrompe(self, IRQ_ERR_CPU));
+// executa a instrução no PC com o motor de referência, ou a sequência
+//   inteira se for uma superinstrução e couber em 'max' instruções
+// retorna o número de instruções executadas
+static int executa_switch(cpu_t *self, int max)
+{
+  int opcode;
+  int executadas = 1;
+  if (pega_opcode(self, &opcode)) {
+    if (opcode >= PRIMEIRA_SUPERINSTRUCAO && opcode < VALOR) {
+      executadas = executa_superinstrucao(self, opcode, max);
+    } else {
+      executa_a_instrucao(self, opcode);
+    }
+  }
+  cpu_verifica_erro(self);
+  return executadas;
+}
+
+// executa até 'n' instruções com o motor de referência
+static int executa_n_switch(cpu_t *self, int n)
+{
+  int executadas = 0;
+  while (executadas < n && self->erro == ERR_OK) {
+    executadas += executa_switch(self, n - executadas);
+    if (self->modo != usuario) break;
+  }
+  return executadas;
+}
+
+// MOTOR ENCADEADO {{{1
+
+// pré-decodifica a instrução em 'pc'
+// retorna o opcode, ou -1 se a instrução não pode ser pré-decodificada
+//   (opcode inválido, argumento fora da memória, ou acesso a um endereço fixo
+//   inválido); essas instruções são executadas pelo motor de referência, que
+//   gera o erro correspondente
+// as instruções que acessam a memória no endereço A1 só são pré-decodificadas
+//   se A1 for válido, e então não precisam verificar o endereço ao executar
+static int decodifica(cpu_t *self, int pc)
+{
+  int opcode;
+  if (mem_le(self->mem, pc, &opcode) != ERR_OK) return -1;
+  if (opcode < 0 || opcode >= VALOR) return -1;
+  // uma superinstrução é decodificada como a sua primeira instrução: com o
+  //   despacho encadeado, executar a sequência separada é mais rápido que
+  //   passar pelo executor de superinstruções
+  opcode = instrucao_componente(opcode, 0);
+  decod_t *d = &self->decod[pc];
+  d->A1 = 0;
+  if (instrucao_num_args(opcode) > 0 && mem_le(self->mem, pc + 1, &d->A1) != ERR_OK) {
+    return -1;
+  }
+  if (instrucao_acessa_mem_A1(opcode) && !mem_faixa_valida(self->mem, d->A1, 1)) {
+    return -1;
   }
+  d->privilegiada = self->privilegiadas[opcode];
+  return opcode;
+}
+
+// executa até 'n' instruções, usando a memória pré-decodificada, com as
+//   mesmas condições de parada de cpu_executa_n
+// o código de cada instrução desvia diretamente para a próxima, sem passar
+//   por um switch (usa "labels as values", uma extensão do gcc)
+// retorna o número de instruções executadas
+static int executa_encadeado(cpu_t *self, int n)
+{
+  static void *rotulos[VALOR] = {
+    [NOP]    = &&l_NOP,    [PARA]   = &&l_PARA,   [CARGI]  = &&l_CARGI,
+    [CARGM]  = &&l_CARGM,  [CARGX]  = &&l_CARGX,  [ARMM]   = &&l_ARMM,
+    [ARMX]   = &&l_ARMX,   [TRAX]   = &&l_TRAX,   [CPXA]   = &&l_CPXA,
+    [INCX]   = &&l_INCX,   [SOMA]   = &&l_SOMA,   [SUB]    = &&l_SUB,
+    [MULT]   = &&l_MULT,   [DIV]    = &&l_DIV,    [RESTO]  = &&l_RESTO,
+    [NEG]    = &&l_NEG,    [DESV]   = &&l_DESV,   [DESVZ]  = &&l_DESVZ,
+    [DESVNZ] = &&l_DESVNZ, [DESVN]  = &&l_DESVN,  [DESVP]  = &&l_DESVP,
+    [CHAMA]  = &&l_CHAMA,  [RET]    = &&l_RET,    [LE]     = &&l_LE,
+    [ESCR]   = &&l_ESCR,   [CHAMAS] = &&l_CHAMAS, [RETI]   = &&l_RETI,
+    [CHAMAC] = &&l_CHAMAC,
+  };
+  int executadas = 0;
+  decod_t *d;
+  int val;
+
+proxima:
+  if (executadas >= n || self->erro != ERR_OK) return executadas;
+  if (executadas > 0 && self->modo != usuario) return executadas;
+  executadas++;
+  if (self->PC < 0 || self->PC >= self->tam_decod) goto lenta;
+  d = &self->decod[self->PC];
+  if (d->rotulo == NULL) {
+    int opcode = decodifica(self, self->PC);
+    if (opcode < 0) goto lenta;
+    d->rotulo = rotulos[opcode];
+  }
+  // as verificações que dependem do modo não podem ser pré-decodificadas
+  if (self->modo == usuario && (self->PC < 100 || d->privilegiada)) goto lenta;
+  goto *d->rotulo;
+
+lenta:
+  executa_1_switch(self);
+  goto proxima;
+
+fim:
+  cpu_verifica_erro(self);
+  goto proxima;
+
+l_NOP:    op_NOP(self);    goto fim;
+l_PARA:   op_PARA(self);   goto fim;
+l_TRAX:   op_TRAX(self);   goto fim;
+l_CPXA:   op_CPXA(self);   goto fim;
+l_INCX:   op_INCX(self);   goto fim;
+l_NEG:    op_NEG(self);    goto fim;
+l_RETI:   op_RETI(self);   goto fim;
+l_CHAMAC: op_CHAMAC(self); goto fim;
+l_CHAMAS: op_CHAMAS(self); goto fim;
+l_CARGI:
+  self->A = d->A1;
+  self->PC += 2;
+  goto fim;
+l_CARGM:
+  self->A = mem_le_rapido(self->mem, d->A1);
+  self->PC += 2;
+  goto fim;
+l_CARGX:
+  if (pega_mem(self, d->A1 + self->X, &val)) {
+    self->A = val;
+    self->PC += 2;
+  }
+  goto fim;
+l_ARMM:
+  mem_escreve_rapido(self->mem, d->A1, self->A);
+  self->PC += 2;
+  goto fim;
+l_ARMX:
+  if (poe_mem(self, d->A1 + self->X, self->A)) {
+    self->PC += 2;
+  }
+  goto fim;
+l_SOMA:
+  self->A += mem_le_rapido(self->mem, d->A1);
+  self->PC += 2;
+  goto fim;
+l_SUB:
+  self->A -= mem_le_rapido(self->mem, d->A1);
+  self->PC += 2;
+  goto fim;
+l_MULT:
+  self->A *= mem_le_rapido(self->mem, d->A1);
+  self->PC += 2;
+  goto fim;
+l_DIV:
+  self->A /= mem_le_rapido(self->mem, d->A1);
+  self->PC += 2;
+  goto fim;
+l_RESTO:
+  self->A %= mem_le_rapido(self->mem, d->A1);
+  self->PC += 2;
+  goto fim;
+l_DESV:
+  self->PC = d->A1;
+  goto fim;
+l_DESVZ:
+  self->PC = (self->A == 0) ? d->A1 : self->PC + 2;
+  goto fim;
+l_DESVNZ:
+  self->PC = (self->A != 0) ? d->A1 : self->PC + 2;
+  goto fim;
+l_DESVN:
+  self->PC = (self->A < 0) ? d->A1 : self->PC + 2;
+  goto fim;
+l_DESVP:
+  self->PC = (self->A > 0) ? d->A1 : self->PC + 2;
+  goto fim;
+l_CHAMA:
+  mem_escreve_rapido(self->mem, d->A1, self->PC + 2);
+  self->PC = d->A1 + 1;
+  goto fim;
+l_RET:
+  self->PC = mem_le_rapido(self->mem, d->A1);
+  goto fim;
+l_LE:
+  if (pega_es(self, d->A1, &val)) {
+    self->A = val;
+    self->PC += 2;
+  }
+  goto fim;
+l_ESCR:
+  if (poe_es(self, d->A1, self->A)) {
+    self->PC += 2;
+  }
+  goto fim;
+}
+
+// MOTOR DE BLOCOS {{{1
+
+// executa as uops do bloco 'b', enquanto couberem em 'n' instruções
+// a execução é equivalente à das instruções originais; os acessos a endereços
+//   fixos foram verificados na tradução, só os indexados (CARGX, ARMX) podem
+//   causar erro
+// retorna o número de instruções executadas, e em *pprox o bloco em que a
+//   execução continua, se ele puder ser usado diretamente
+static int executa_bloco(cpu_t *self, bloco_t *b, int n, bloco_t **pprox)
+{
+  int executadas = 0;
+  int val;
+  int sucessor;
+  *pprox = NULL;
+  self->abandona_bloco = false;
+
+  for (uop_t *u = b->uops; ; u++) {
+    if (executadas + u->n_instr > n) return executadas;
+    executadas += u->n_instr;
+    switch (u->cod) {
+      case UOP_NOP:
+        self->PC += 1;
+        break;
+      case UOP_CARGI:
+        self->A = u->a1;
+        self->PC += 2;
+        break;
+      case UOP_CARGM:
+        self->A = mem_le_rapido(self->mem, u->a1);
+        self->PC += 2;
+        break;
+      case UOP_CARGX:
+        if (pega_mem(self, u->a1 + self->X, &val)) {
+          self->A = val;
+          self->PC += 2;
+        }
+        break;
+      case UOP_ARMM:
+        mem_escreve_rapido(self->mem, u->a1, self->A);
+        self->PC += 2;
+        break;
+      case UOP_ARMX:
+        if (poe_mem(self, u->a1 + self->X, self->A)) {
+          self->PC += 2;
+        }
+        break;
+      case UOP_TRAX:
+        val = self->A;
+        self->A = self->X;
+        self->X = val;
+        self->PC += 1;
+        break;
+      case UOP_CPXA:
+        self->A = self->X;
+        self->PC += 1;
+        break;
+      case UOP_INCX:
+        self->X += 1;
+        self->PC += 1;
+        break;
+      case UOP_SOMA:
+        self->A += mem_le_rapido(self->mem, u->a1);
+        self->PC += 2;
+        break;
+      case UOP_SUB:
+        self->A -= mem_le_rapido(self->mem, u->a1);
+        self->PC += 2;
+        break;
+      case UOP_MULT:
+        self->A *= mem_le_rapido(self->mem, u->a1);
+        self->PC += 2;
+        break;
+      case UOP_DIV:
+        self->A /= mem_le_rapido(self->mem, u->a1);
+        self->PC += 2;
+        break;
+      case UOP_RESTO:
+        self->A %= mem_le_rapido(self->mem, u->a1);
+        self->PC += 2;
+        break;
+      case UOP_NEG:
+        self->A = -self->A;
+        self->PC += 1;
+        break;
+      case UOP_CPXA_SUB:
+        self->A = self->X - mem_le_rapido(self->mem, u->a1);
+        self->PC += 3;
+        break;
+      case UOP_CPXA_RESTO:
+        self->A = self->X % mem_le_rapido(self->mem, u->a1);
+        self->PC += 3;
+        break;
+      case UOP_CARGM_SUB:
+        self->A = mem_le_rapido(self->mem, u->a1) - mem_le_rapido(self->mem, u->a2);
+        self->PC += 4;
+        break;
+      case UOP_CARGM_SOMA_ARMM:
+        self->A = mem_le_rapido(self->mem, u->a1) + mem_le_rapido(self->mem, u->a2);
+        mem_escreve_rapido(self->mem, u->a3, self->A);
+        self->PC += 6;
+        break;
+      case UOP_DESV:
+        self->PC = u->a1;
+        sucessor = 1;
+        goto fim_do_bloco;
+      case UOP_DESVZ:
+        sucessor = (self->A == 0);
+        self->PC = sucessor ? u->a1 : u->pc + 2;
+        goto fim_do_bloco;
+      case UOP_DESVNZ:
+        sucessor = (self->A != 0);
+        self->PC = sucessor ? u->a1 : u->pc + 2;
+        goto fim_do_bloco;
+      case UOP_DESVN:
+        sucessor = (self->A < 0);
+        self->PC = sucessor ? u->a1 : u->pc + 2;
+        goto fim_do_bloco;
+      case UOP_DESVP:
+        sucessor = (self->A > 0);
+        self->PC = sucessor ? u->a1 : u->pc + 2;
+        goto fim_do_bloco;
+      case UOP_CHAMA:
+        mem_escreve_rapido(self->mem, u->a1, self->PC + 2);
+        self->PC = u->a1 + 1;
+        sucessor = 1;
+        goto fim_do_bloco;
+      case UOP_RET:
+        self->PC = mem_le_rapido(self->mem, u->a1);
+        sucessor = 1;
+        goto fim_do_bloco;
+      case UOP_SEGUE:
+        self->PC = u->a1;
+        sucessor = 0;
+        goto fim_do_bloco;
+    }
+    if (self->erro != ERR_OK) {
+      cpu_verifica_erro(self);
+      return executadas;
+    }
+    // uma escrita alterou o código de algum bloco, talvez deste
+    if (self->abandona_bloco) return executadas;
+  }
+
+fim_do_bloco:
+  if (self->erro != ERR_OK) {
+    cpu_verifica_erro(self);
+  } else if (!self->abandona_bloco) {
+    *pprox = blocos_sucessor(self->blocos, b, sucessor, self->PC);
+  }
+  return executadas;
+}
+
+// executa até 'n' instruções, usando a cache de blocos traduzidos, com as
+//   mesmas condições de parada de cpu_executa_n
+// só o código de modo usuário é executado em blocos; o resto (o tratador de
+//   interrupção e as instruções que não são traduzidas) é executado pelo
+//   motor de referência
+// retorna o número de instruções executadas
+static int executa_blocos(cpu_t *self, int n)
+{
+  int executadas = 0;
+  bloco_t *b = NULL;
+  while (executadas < n && self->erro == ERR_OK) {
+    if (executadas > 0 && self->modo != usuario) break;
+    if (self->modo == usuario) {
+      if (b == NULL) b = blocos_busca(self->blocos, self->PC);
+      if (b != NULL && b->n_uops > 0) {
+        int feitas = executa_bloco(self, b, n - executadas, &b);
+        if (feitas > 0) {
+          executadas += feitas;
+          continue;
+        }
+      }
+    }
+    // não tem bloco, ou a primeira uop não cabe no que falta executar
+    b = NULL;
+    executa_1_switch(self);
+    executadas++;
+  }
+  return executadas;
+}
+
+// EXECUÇÃO {{{1
+
+void cpu_executa_1(cpu_t *self)
+{
+  // não executa se CPU já estiver em erro
+  if (self->erro != ERR_OK) return;
+
+  if (self->motor == CPU_MOTOR_ENCADEADO) {
+    executa_encadeado(self, 1);
+  } else if (self->motor == CPU_MOTOR_BLOCOS) {
+    executa_blocos(self, 1);
+  } else {
+    executa_1_switch(self);
+  }
+}
+
+int cpu_executa_n(cpu_t *self, int n)
+{
+  // em modo supervisor, executa uma só: depois dela (um RETI, por exemplo)
+  //   pode ter que ser atendida uma interrupção que está pendente
+  if (self->modo != usuario && n > 1) n = 1;
+  if (self->motor == CPU_MOTOR_ENCADEADO) {
+    return executa_encadeado(self, n);
+  } else if (self->motor == CPU_MOTOR_BLOCOS) {
+    return executa_blocos(self, n);
+  } else {
+    return executa_n_switch(self, n);
+  }
+}
+
+bool cpu_parada(cpu_t *self)
+{
+  return self->erro == ERR_CPU_PARADA;
 }
 
 // INTERRUPÇÃO {{{1
 
+void cpu_inicia(cpu_t *self, int pc)
+{
+  self->PC = pc;
+  self->modo = supervisor;
+  self->erro = ERR_OK;
+}
+
 bool cpu_interrompe(cpu_t *self, irq_t irq)
 {
   // só aceita interrupção em modo usuário ou quando a CPU está dormindo
@@ -498,10 +1026,12 @@ bool cpu_interrompe(cpu_t *self, irq_t irq)
   self->modo = supervisor;
 
   // esta é uma CPU boazinha, salva todo o estado interno da CPU no início da memória
+  // o erro é copiado antes porque poe_mem altera self->erro
+  err_t erro = self->erro;
   poe_mem(self, IRQ_END_PC,          self->PC);
   poe_mem(self, IRQ_END_A,           self->A);
   poe_mem(self, IRQ_END_X,           self->X);
-  poe_mem(self, IRQ_END_erro,        self->erro);
+  poe_mem(self, IRQ_END_erro,        erro);
   poe_mem(self, IRQ_END_complemento, self->complemento);
   poe_mem(self, IRQ_END_modo,        usuario);
 
@@ -16,6 +16,18 @@ typedef struct cpu_t cpu_t; // tipo opaco
 // os modos de execução da CPU -- normalmente seria interno a CPU.c, mas o SO vai precisar disso
 typedef enum { supervisor, usuario } cpu_modo_t;
 
+// os motores de execução de instruções
+// CPU_MOTOR_SWITCH é o interpretador de referência: busca e decodifica cada
+//   instrução a cada execução
+// CPU_MOTOR_ENCADEADO mantém uma cópia pré-decodificada da memória (endereço
+//   do código que implementa a instrução e argumento já lido, para cada
+//   endereço), e despacha com "computed goto"; o resultado da execução é
+//   idêntico ao do motor de referência
+// CPU_MOTOR_BLOCOS traduz blocos básicos do código em modo usuário para
+//   micro-operações, guardados em uma cache (ver blocos.h), e executa um
+//   bloco inteiro de cada vez; também tem resultado idêntico
+typedef enum { CPU_MOTOR_SWITCH, CPU_MOTOR_ENCADEADO, CPU_MOTOR_BLOCOS } cpu_motor_t;
+
 // tipo da função a ser chamada quando executar a instrução CHAMAC
 typedef int (*func_chamaC_t)(void *argC, int reg_A);
 
@@ -27,12 +39,29 @@ cpu_t *cpu_cria(mem_t *mem, es_t *es);
 // destrói a unidade de execução
 void cpu_destroi(cpu_t *self);
 
+// escolhe o motor de execução (o padrão é CPU_MOTOR_SWITCH)
+void cpu_define_motor(cpu_t *self, cpu_motor_t motor);
+
 // executa a instrução apontada pelo PC
 //   se a CPU estiver em erro, não executa
 //   se a execução causar algum erro, altera o estado da CPU
 //     e causa uma interrupção
 void cpu_executa_1(cpu_t *self);
 
+// executa até 'n' instruções, como chamadas sucessivas a cpu_executa_1
+// para antes de 'n' se a CPU parar, entrar em erro, ou deixar de estar em modo
+//   usuário (por ter aceito uma interrupção ou chamada de sistema); em modo
+//   supervisor, executa no máximo uma instrução
+// dessa forma, tudo o que o SO observa (o relógio, os dispositivos) pode ser
+//   atualizado pelo chamador depois da execução, como se tivesse sido
+//   atualizado a cada instrução
+// retorna o número de instruções executadas (0 se a CPU estava parada)
+int cpu_executa_n(cpu_t *self, int n);
+
+// retorna true se a CPU está parada (executou a instrução PARA e está esperando
+//   uma interrupção para voltar a executar)
+bool cpu_parada(cpu_t *self);
+
 // implementa uma interrupção
 // passa para modo supervisor, salva o estado da CPU no início da memória,
 //   altera A para identificar a requisição de interrupção, altera PC para
@@ -40,6 +69,11 @@ void cpu_executa_1(cpu_t *self);
 // retorna true se interrupção foi aceita ou false caso contrário
 bool cpu_interrompe(cpu_t *self, irq_t irq);
 
+// faz a CPU continuar a execução no endereço 'pc', em modo supervisor (para
+//   executar um programa diretamente, sem SO: o programa tem acesso aos
+//   dispositivos, mas não pode causar erro, que não teria quem tratasse)
+void cpu_inicia(cpu_t *self, int pc);
+
 // define a função a chamar quando executar a instrução CHAMAC
 // e o argumento a passar para ela (normalmente, um ponteiro para o SO)
 void cpu_define_chamaC(cpu_t *self, func_chamaC_t func, void *argC);
@@ -47,4 +81,9 @@ void cpu_define_chamaC(cpu_t *self, func_chamaC_t func, void *argC);
 // concatena a descrição do estado da CPU no final de str
 void cpu_concatena_descricao(cpu_t *self, char *str);
 
+// concatena estatísticas do motor de execução no final de str (não concatena
+//   nada se o motor não tiver estatísticas), sem que str passe de 'tam'
+//   caracteres (contando o '\0')
+void cpu_concatena_estatisticas(cpu_t *self, char *str, int tam);
+
 #endif // CPU_H
@@ -27,6 +27,8 @@ typedef enum {
   D_RELOGIO_REAL          = 17,
   D_RELOGIO_TIMER         = 18,
   D_RELOGIO_INTERRUPCAO   = 19,
+  D_PIC_PENDENTES         = 20,
+  D_PIC_MASCARA           = 21,
   N_DISPOSITIVOS
 } dispositivo_id_t;
 
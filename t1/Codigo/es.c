@@ -15,6 +15,10 @@ typedef struct {
    f_leitura_t f_leitura;
    // função para escrever um valor no dispositivo
    f_escrita_t f_escrita;
+   // função para escrever vários valores (ou NULL)
+   f_escrita_bloco_t f_escrita_bloco;
+   // função para ler vários valores (ou NULL)
+   f_leitura_bloco_t f_leitura_bloco;
    // controlador do dispositivo (argumento para as funções acima)
    void *controladora;
    // identificador do dispositivo (argumento para as funções acima)
@@ -47,6 +51,24 @@ bool es_registra_dispositivo(es_t *self, dispositivo_id_t dispositivo,
   self->dispositivos[dispositivo].id = id;
   self->dispositivos[dispositivo].f_leitura = f_leitura;
   self->dispositivos[dispositivo].f_escrita = f_escrita;
+  self->dispositivos[dispositivo].f_escrita_bloco = NULL;
+  self->dispositivos[dispositivo].f_leitura_bloco = NULL;
+  return true;
+}
+
+bool es_registra_escrita_bloco(es_t *self, dispositivo_id_t dispositivo,
+                               f_escrita_bloco_t f_escrita_bloco)
+{
+  if (dispositivo < 0 || dispositivo >= N_DISPOSITIVOS) return false;
+  self->dispositivos[dispositivo].f_escrita_bloco = f_escrita_bloco;
+  return true;
+}
+
+bool es_registra_leitura_bloco(es_t *self, dispositivo_id_t dispositivo,
+                               f_leitura_bloco_t f_leitura_bloco)
+{
+  if (dispositivo < 0 || dispositivo >= N_DISPOSITIVOS) return false;
+  self->dispositivos[dispositivo].f_leitura_bloco = f_leitura_bloco;
   return true;
 }
 
@@ -67,3 +89,41 @@ err_t es_escreve(es_t *self, dispositivo_id_t dispositivo, int valor)
   int id = self->dispositivos[dispositivo].id;
   return self->dispositivos[dispositivo].f_escrita(controladora, id, valor);
 }
+
+err_t es_le_bloco(es_t *self, dispositivo_id_t dispositivo,
+                  int *valores, int n, int *plidos)
+{
+  *plidos = 0;
+  if (dispositivo < 0 || dispositivo >= N_DISPOSITIVOS) return ERR_DISP_INV;
+  dispositivo_t *disp = &self->dispositivos[dispositivo];
+  if (disp->f_leitura_bloco != NULL) {
+    return disp->f_leitura_bloco(disp->controladora, disp->id, valores, n, plidos);
+  }
+  if (disp->f_leitura == NULL) return ERR_OP_INV;
+  for (int i = 0; i < n; i++) {
+    err_t err = disp->f_leitura(disp->controladora, disp->id, &valores[i]);
+    if (err == ERR_OCUP && i > 0) break;
+    if (err != ERR_OK) return err;
+    (*plidos)++;
+  }
+  return ERR_OK;
+}
+
+err_t es_escreve_bloco(es_t *self, dispositivo_id_t dispositivo,
+                       const int *valores, int n, int *pescritos)
+{
+  *pescritos = 0;
+  if (dispositivo < 0 || dispositivo >= N_DISPOSITIVOS) return ERR_DISP_INV;
+  dispositivo_t *disp = &self->dispositivos[dispositivo];
+  if (disp->f_escrita_bloco != NULL) {
+    return disp->f_escrita_bloco(disp->controladora, disp->id, valores, n, pescritos);
+  }
+  if (disp->f_escrita == NULL) return ERR_OP_INV;
+  for (int i = 0; i < n; i++) {
+    err_t err = disp->f_escrita(disp->controladora, disp->id, valores[i]);
+    if (err == ERR_OCUP) break;
+    if (err != ERR_OK) return err;
+    (*pescritos)++;
+  }
+  return ERR_OK;
+}
@@ -24,6 +24,12 @@ typedef struct es_t es_t; // declara o tipo como sendo uma estrutura opaca
 // a função de escrita recebe o valor a ser escrito.
 typedef err_t (*f_leitura_t)(void *controladora, int id, int *endereco);
 typedef err_t (*f_escrita_t)(void *controladora, int id, int valor);
+// um dispositivo pode também aceitar a escrita de vários valores de uma vez;
+//   a função recebe os 'n' valores a escrever, e coloca em '*pescritos'
+//   quantos foram aceitos (pode ser menos que 'n', se o dispositivo não tiver
+//   espaço para todos)
+typedef err_t (*f_escrita_bloco_t)(void *controladora, int id,
+                                   const int *valores, int n, int *pescritos);
 
 // aloca e inicializa um controlador de E/S
 // retorna NULL em caso de erro
@@ -44,6 +50,21 @@ bool es_registra_dispositivo(es_t *self, dispositivo_id_t dispositivo,
                              void *controladora, int id,
                              f_leitura_t f_leitura, f_escrita_t f_escrita);
 
+// e também a leitura de vários valores de uma vez; a função coloca em
+//   'valores' até 'n' valores, e em '*plidos' quantos foram lidos
+typedef err_t (*f_leitura_bloco_t)(void *controladora, int id,
+                                   int *valores, int n, int *plidos);
+
+// registra a função de escrita em bloco de um dispositivo já registrado
+// retorna false se não foi possível registrar
+bool es_registra_escrita_bloco(es_t *self, dispositivo_id_t dispositivo,
+                               f_escrita_bloco_t f_escrita_bloco);
+
+// registra a função de leitura em bloco de um dispositivo já registrado
+// retorna false se não foi possível registrar
+bool es_registra_leitura_bloco(es_t *self, dispositivo_id_t dispositivo,
+                               f_leitura_bloco_t f_leitura_bloco);
+
 // lê um inteiro de um dispositivo
 // retorna ERR_OK se bem sucedido, ou
 //   ERR_DISP_INV se dispositivo desconhecido
@@ -56,4 +77,22 @@ err_t es_le(es_t *self, dispositivo_id_t dispositivo, int *pvalor);
 //   ERR_OP_INV se operação inválida
 err_t es_escreve(es_t *self, dispositivo_id_t dispositivo, int valor);
 
+// lê até 'n' inteiros de um dispositivo, e coloca em '*plidos' quantos
+//   foram lidos
+// se o dispositivo não tem leitura em bloco, lê um valor por vez, até 'n'
+//   ou até o dispositivo recusar por estar ocupado (se recusar o primeiro,
+//   retorna ERR_OCUP)
+// retorna ERR_OK se leu algum valor, ou os mesmos erros de es_le
+err_t es_le_bloco(es_t *self, dispositivo_id_t dispositivo,
+                  int *valores, int n, int *plidos);
+
+// escreve até 'n' inteiros em um dispositivo, e coloca em '*pescritos'
+//   quantos foram escritos
+// se o dispositivo não tem escrita em bloco, escreve um valor por vez, até
+//   terminar ou o dispositivo recusar um valor por estar ocupado
+// retorna ERR_OK se bem sucedido (mesmo que nem todos tenham sido escritos),
+//   ou os mesmos erros de es_escreve
+err_t es_escreve_bloco(es_t *self, dispositivo_id_t dispositivo,
+                       const int *valores, int n, int *pescritos);
+
 #endif // ES_H
@@ -0,0 +1,23 @@
+// escalonador.h
+// os escalonadores de processos do SO
+// simulador de computador
+// so24b
+
+#ifndef ESCALONADOR_H
+#define ESCALONADOR_H
+
+// os escalonadores de processos
+typedef enum {
+  ESCALONADOR_NORMAL,     // o primeiro pronto da tabela, sem preempção
+  ESCALONADOR_ROUND_ROBIN,
+  ESCALONADOR_ROUND_ROBIN_PRIORIDADE,
+  // filas multinível com realimentação: ver so.c
+  ESCALONADOR_MLFQ,
+  // completamente justo, por tempo virtual de execução: ver so.c
+  ESCALONADOR_CFS,
+} escalonador_t;
+
+// número de níveis do escalonador com filas multinível (ESCALONADOR_MLFQ)
+#define N_NIVEIS_MLFQ 3
+
+#endif // ESCALONADOR_H
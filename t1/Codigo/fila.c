@@ -0,0 +1,99 @@
+// fila.c
+// fila de processos prontos do SO, ordenada por prioridade
+// simulador de computador
+// so24b
+
+#include "fila.h"
+
+#include <stdlib.h>
+#include <assert.h>
+
+struct fila_t {
+  processo_t *inicio;
+  processo_t *fim;
+  int n;
+};
+
+fila_t *fila_cria(void)
+{
+  fila_t *self = malloc(sizeof(*self));
+  assert(self != NULL);
+
+  self->inicio = NULL;
+  self->fim = NULL;
+  self->n = 0;
+
+  return self;
+}
+
+void fila_destroi(fila_t *self)
+{
+  // os processos que ainda estão na fila ficam sem fila
+  for (processo_t *p = self->inicio; p != NULL; p = p->proximo_fila) {
+    p->fila = NULL;
+  }
+  free(self);
+}
+
+void fila_insere(fila_t *self, processo_t *proc)
+{
+  if (proc->fila == self) fila_remove(self, proc);
+  assert(proc->fila == NULL);
+
+  // o novo fica depois do último com prioridade maior ou igual à dele
+  processo_t *anterior = self->fim;
+  while (anterior != NULL && anterior->prioridade < proc->prioridade) {
+    anterior = anterior->anterior_fila;
+  }
+
+  proc->anterior_fila = anterior;
+  if (anterior == NULL) {
+    proc->proximo_fila = self->inicio;
+    self->inicio = proc;
+  } else {
+    proc->proximo_fila = anterior->proximo_fila;
+    anterior->proximo_fila = proc;
+  }
+  if (proc->proximo_fila != NULL) {
+    proc->proximo_fila->anterior_fila = proc;
+  } else {
+    self->fim = proc;
+  }
+  proc->fila = self;
+  self->n++;
+}
+
+void fila_remove(fila_t *self, processo_t *proc)
+{
+  if (proc->fila != self) return;
+
+  if (proc->anterior_fila != NULL) {
+    proc->anterior_fila->proximo_fila = proc->proximo_fila;
+  } else {
+    self->inicio = proc->proximo_fila;
+  }
+  if (proc->proximo_fila != NULL) {
+    proc->proximo_fila->anterior_fila = proc->anterior_fila;
+  } else {
+    self->fim = proc->anterior_fila;
+  }
+  proc->proximo_fila = NULL;
+  proc->anterior_fila = NULL;
+  proc->fila = NULL;
+  self->n--;
+}
+
+processo_t *fila_primeiro(fila_t *self)
+{
+  return self->inicio;
+}
+
+processo_t *fila_proximo(processo_t *proc)
+{
+  return proc->proximo_fila;
+}
+
+int fila_n(fila_t *self)
+{
+  return self->n;
+}
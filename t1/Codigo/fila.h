@@ -0,0 +1,45 @@
+// fila.h
+// fila de processos prontos do SO, ordenada por prioridade
+// simulador de computador
+// so24b
+
+#ifndef FILA_H
+#define FILA_H
+
+// Os elos da fila ficam no próprio descritor do processo (campos fila,
+//   proximo_fila e anterior_fila), então inserir e retirar não alocam
+//   memória, e um processo está em no máximo uma fila.
+// A fila é mantida em ordem decrescente de prioridade; entre processos de
+//   mesma prioridade, na ordem de chegada. A inserção procura a posição a
+//   partir do fim, então é O(1) quando as prioridades são iguais (como nos
+//   escalonadores sem prioridade). A remoção é sempre O(1).
+
+#include "processo.h"
+
+#include <stdbool.h>
+
+typedef struct fila_t fila_t;
+
+// cria uma fila vazia
+fila_t *fila_cria(void);
+
+// destrói a fila (os processos não são afetados)
+void fila_destroi(fila_t *self);
+
+// insere 'proc' na posição correspondente à sua prioridade
+// se ele já estiver na fila, é reposicionado
+void fila_insere(fila_t *self, processo_t *proc);
+
+// retira 'proc' da fila; não faz nada se ele não estiver nela
+void fila_remove(fila_t *self, processo_t *proc);
+
+// o primeiro processo da fila (o de maior prioridade), ou NULL
+processo_t *fila_primeiro(fila_t *self);
+
+// o processo depois de 'proc' na fila em que ele está, ou NULL
+processo_t *fila_proximo(processo_t *proc);
+
+// número de processos na fila
+int fila_n(fila_t *self);
+
+#endif // FILA_H
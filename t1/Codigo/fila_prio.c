@@ -0,0 +1,146 @@
+// fila_prio.c
+// fila de processos prontos com prioridade, em um heap binário
+// simulador de computador
+// so24b
+
+#include "fila_prio.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#define TAM_INICIAL 64
+
+struct fila_prio_t {
+  processo_t **heap;
+  int tam;
+  int n;
+  // contador de inserções, para desempatar as chaves iguais
+  unsigned long ordem;
+};
+
+fila_prio_t *fila_prio_cria(void)
+{
+  fila_prio_t *self = malloc(sizeof(*self));
+  assert(self != NULL);
+
+  self->tam = TAM_INICIAL;
+  self->heap = malloc(self->tam * sizeof(*self->heap));
+  assert(self->heap != NULL);
+  self->n = 0;
+  self->ordem = 0;
+
+  return self;
+}
+
+void fila_prio_destroi(fila_prio_t *self)
+{
+  for (int i = 0; i < self->n; i++) {
+    self->heap[i]->fila_prio = NULL;
+  }
+  free(self->heap);
+  free(self);
+}
+
+// HEAP
+
+// 'a' deve sair antes de 'b'
+static bool antes(processo_t *a, processo_t *b)
+{
+  if (a->chave_prio != b->chave_prio) return a->chave_prio < b->chave_prio;
+  return a->ordem_prio < b->ordem_prio;
+}
+
+static void coloca(fila_prio_t *self, int i, processo_t *proc)
+{
+  self->heap[i] = proc;
+  proc->indice_prio = i;
+}
+
+// move o processo na posição 'i' em direção à raiz, até a posição certa
+static void sobe(fila_prio_t *self, int i)
+{
+  processo_t *proc = self->heap[i];
+  while (i > 0) {
+    int pai = (i - 1) / 2;
+    if (!antes(proc, self->heap[pai])) break;
+    coloca(self, i, self->heap[pai]);
+    i = pai;
+  }
+  coloca(self, i, proc);
+}
+
+// move o processo na posição 'i' em direção às folhas, até a posição certa
+static void desce(fila_prio_t *self, int i)
+{
+  processo_t *proc = self->heap[i];
+  for (;;) {
+    int filho = 2 * i + 1;
+    if (filho >= self->n) break;
+    if (filho + 1 < self->n && antes(self->heap[filho + 1], self->heap[filho])) {
+      filho++;
+    }
+    if (!antes(self->heap[filho], proc)) break;
+    coloca(self, i, self->heap[filho]);
+    i = filho;
+  }
+  coloca(self, i, proc);
+}
+
+// OPERAÇÕES
+
+void fila_prio_insere(fila_prio_t *self, processo_t *proc, double chave)
+{
+  proc->chave_prio = chave;
+  proc->ordem_prio = self->ordem++;
+  if (proc->fila_prio == self) {
+    // já está no heap: só muda de lugar
+    int i = proc->indice_prio;
+    sobe(self, i);
+    if (proc->indice_prio == i) desce(self, i);
+    return;
+  }
+  assert(proc->fila_prio == NULL);
+
+  if (self->n == self->tam) {
+    self->tam *= 2;
+    self->heap = realloc(self->heap, self->tam * sizeof(*self->heap));
+    assert(self->heap != NULL);
+  }
+  proc->fila_prio = self;
+  coloca(self, self->n, proc);
+  self->n++;
+  sobe(self, self->n - 1);
+}
+
+void fila_prio_remove(fila_prio_t *self, processo_t *proc)
+{
+  if (proc->fila_prio != self) return;
+
+  int i = proc->indice_prio;
+  self->n--;
+  if (i < self->n) {
+    // o último ocupa o lugar do retirado, e pode ter que subir ou descer
+    processo_t *ultimo = self->heap[self->n];
+    coloca(self, i, ultimo);
+    sobe(self, i);
+    if (ultimo->indice_prio == i) desce(self, i);
+  }
+  proc->fila_prio = NULL;
+}
+
+processo_t *fila_prio_primeiro(fila_prio_t *self)
+{
+  return self->n == 0 ? NULL : self->heap[0];
+}
+
+int fila_prio_n(fila_prio_t *self)
+{
+  return self->n;
+}
+
+processo_t *fila_prio_elemento(fila_prio_t *self, int i)
+{
+  assert(i >= 0 && i < self->n);
+  return self->heap[i];
+}
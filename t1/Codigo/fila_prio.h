@@ -0,0 +1,46 @@
+// fila_prio.h
+// fila de processos prontos com prioridade, em um heap binário
+// simulador de computador
+// so24b
+
+#ifndef FILA_PRIO_H
+#define FILA_PRIO_H
+
+// Os processos são retirados em ordem crescente de chave; entre chaves
+//   iguais, na ordem em que foram inseridos. A chave é dada na inserção e
+//   fica no descritor (campo chave_prio), junto com a posição do processo no
+//   heap (indice_prio), então inserir, retirar qualquer processo e mudar a
+//   chave de um processo são O(log n), e encontrar o primeiro é O(1).
+// O vetor do heap cresce dobrando de tamanho quando enche, e nunca diminui;
+//   fora isso, as operações não alocam memória.
+// Um processo está em no máximo uma fila de prioridade (campo fila_prio).
+
+#include "processo.h"
+
+typedef struct fila_prio_t fila_prio_t;
+
+// cria uma fila vazia
+fila_prio_t *fila_prio_cria(void);
+
+// destrói a fila (os processos não são afetados)
+void fila_prio_destroi(fila_prio_t *self);
+
+// insere 'proc' com a chave 'chave'
+// se ele já estiver na fila, muda a chave e o coloca depois dos que já
+//   estão na fila com a mesma chave
+void fila_prio_insere(fila_prio_t *self, processo_t *proc, double chave);
+
+// retira 'proc' da fila; não faz nada se ele não estiver nela
+void fila_prio_remove(fila_prio_t *self, processo_t *proc);
+
+// o processo de menor chave, ou NULL se a fila estiver vazia
+processo_t *fila_prio_primeiro(fila_prio_t *self);
+
+// número de processos na fila
+int fila_prio_n(fila_prio_t *self);
+
+// o processo na posição 'i' do heap (0 a fila_prio_n()-1), para percorrer
+//   a fila; só o primeiro está na ordem de retirada
+processo_t *fila_prio_elemento(fila_prio_t *self, int i);
+
+#endif // FILA_PRIO_H
@@ -0,0 +1,320 @@
+// gera_carga.c
+// gera programas sintéticos para testar o escalonador e as chamadas de sistema
+// simulador de computador
+// so24b
+
+// gera um processo inicial, que cria K trabalhadores e espera por eles; cada
+//   trabalhador pode por sua vez criar F filhos, iguais a ele mas sem filhos
+// cada trabalhador (e cada filho) executa R rajadas de CPU de C voltas de um
+//   laço, e escreve um caractere no terminal a cada E rajadas (chamada
+//   SO_ESCR), antes de esperar pelos filhos e morrer
+// os programas ficam em NOME_init.asm, NOME_i.asm e NOME_i_j.asm, com
+//   endereços de carga consecutivos a partir do endereço base (a memória
+//   padrão do simulador termina em 10000, que é o base padrão); a lista com
+//   o nome e o endereço de cada um vai para NOME.lst, para a montagem
+// não faz parte do "all"; use, por exemplo, "make carga CARGA='-k 100'" e
+//   execute com "./main -M <memória> -i carga_init.maq" (a memória necessária
+//   é informada na geração)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TAM_NOME 100
+
+typedef enum { ESPERA_ORDEM, ESPERA_INVERSA, ESPERA_NENHUMA } espera_t;
+
+// os parâmetros da carga
+typedef struct {
+  char *nome;
+  int base;
+  int trabalhadores;  // K
+  int filhos;         // F
+  int rajadas;        // R
+  int tam_rajada;     // C
+  int es_a_cada;      // E, 0 para não escrever
+  espera_t espera;
+} param_t;
+
+// um arquivo .asm em geração, com o número de palavras geradas até agora,
+//   para saber onde começa o próximo programa
+typedef struct {
+  FILE *arq;
+  int tam;
+} asm_t;
+
+// GERAÇÃO DE CÓDIGO
+
+static void instr(asm_t *a, char *rotulo, char *nome, char *arg)
+{
+  if (arg == NULL) {
+    fprintf(a->arq, "%-9s%s\n", rotulo, nome);
+    a->tam++;
+  } else {
+    fprintf(a->arq, "%-9s%-7s%s\n", rotulo, nome, arg);
+    a->tam += 2;
+  }
+}
+
+static void instr_n(asm_t *a, char *rotulo, char *nome, int arg)
+{
+  char txt[20];
+  sprintf(txt, "%d", arg);
+  instr(a, rotulo, nome, txt);
+}
+
+static void dado_valor(asm_t *a, char *rotulo, int valor)
+{
+  fprintf(a->arq, "%-9s%-7s%d\n", rotulo, "valor", valor);
+  a->tam++;
+}
+
+static void dado_espaco(asm_t *a, char *rotulo, int n)
+{
+  fprintf(a->arq, "%-9s%-7s%d\n", rotulo, "espaco", n);
+  a->tam += n;
+}
+
+static void dado_string(asm_t *a, char *rotulo, char *str)
+{
+  fprintf(a->arq, "%-9s%-7s'%s'\n", rotulo, "string", str);
+  a->tam += strlen(str) + 1;
+}
+
+// nome do programa, sem ".maq": o inicial (trab < 0), um trabalhador
+//   (filho < 0) ou um filho de um trabalhador
+static void nome_prog(param_t *p, int trab, int filho, char nome[TAM_NOME])
+{
+  if (trab < 0) {
+    snprintf(nome, TAM_NOME, "%s_init", p->nome);
+  } else if (filho < 0) {
+    snprintf(nome, TAM_NOME, "%s_%d", p->nome, trab);
+  } else {
+    snprintf(nome, TAM_NOME, "%s_%d_%d", p->nome, trab, filho);
+  }
+}
+
+// gera um programa que cria os filhos 'filhos[0..n_filhos-1]', executa
+//   'rajadas' rajadas de CPU, espera pelos filhos e morre
+// retorna o tamanho do programa, em palavras
+static int gera_programa(param_t *p, char *nome, int endereco, int rajadas,
+                         char letra, int n_filhos, char filhos[][TAM_NOME])
+{
+  char nome_arq[TAM_NOME + 5];
+  snprintf(nome_arq, sizeof(nome_arq), "%s.asm", nome);
+  asm_t a = { fopen(nome_arq, "w"), 0 };
+  if (a.arq == NULL) {
+    perror(nome_arq);
+    exit(1);
+  }
+  char rot[20], rot2[20];
+
+  fprintf(a.arq, "; %s -- gerado por gera_carga, carga em %d\n", nome, endereco);
+  fprintf(a.arq, "; cria %d processos, executa %d rajadas de %d voltas",
+          n_filhos, rajadas, p->tam_rajada);
+  if (rajadas > 0 && p->es_a_cada > 0) {
+    fprintf(a.arq, ", escreve '%c' a cada %d rajadas", letra, p->es_a_cada);
+  }
+  fprintf(a.arq, "\n\n");
+  fprintf(a.arq, "SO_ESCR        define 2\n");
+  fprintf(a.arq, "SO_CRIA_PROC   define 7\n");
+  fprintf(a.arq, "SO_MATA_PROC   define 8\n");
+  fprintf(a.arq, "SO_ESPERA_PROC define 9\n\n");
+
+  // cria os filhos
+  for (int i = 0; i < n_filhos; i++) {
+    sprintf(rot, "nome_%d", i);
+    sprintf(rot2, "pid_%d", i);
+    instr(&a, "", "cargi", rot);
+    instr(&a, "", "trax", NULL);
+    instr(&a, "", "cargi", "SO_CRIA_PROC");
+    instr(&a, "", "chamas", NULL);
+    instr(&a, "", "armm", rot2);
+  }
+
+  // rajadas de CPU, com uma escrita a cada tantas
+  bool escreve = rajadas > 0 && p->es_a_cada > 0;
+  if (rajadas > 0) {
+    instr_n(&a, "", "cargi", rajadas);
+    instr(&a, "", "armm", "rajadas");
+    if (escreve) {
+      instr_n(&a, "", "cargi", p->es_a_cada);
+      instr(&a, "", "armm", "cont_es");
+    }
+    instr_n(&a, "rajada", "cargi", p->tam_rajada);
+    instr(&a, "laco", "sub", "um");
+    instr(&a, "", "desvnz", "laco");
+    if (escreve) {
+      instr(&a, "", "cargm", "cont_es");
+      instr(&a, "", "sub", "um");
+      instr(&a, "", "armm", "cont_es");
+      instr(&a, "", "desvnz", "sem_es");
+      instr_n(&a, "", "cargi", p->es_a_cada);
+      instr(&a, "", "armm", "cont_es");
+      instr_n(&a, "", "cargi", letra);
+      instr(&a, "", "trax", NULL);
+      instr(&a, "", "cargi", "SO_ESCR");
+      instr(&a, "", "chamas", NULL);
+    }
+    instr(&a, escreve ? "sem_es" : "", "cargm", "rajadas");
+    instr(&a, "", "sub", "um");
+    instr(&a, "", "armm", "rajadas");
+    instr(&a, "", "desvnz", "rajada");
+  }
+
+  // espera os filhos
+  if (p->espera != ESPERA_NENHUMA) {
+    for (int k = 0; k < n_filhos; k++) {
+      int i = p->espera == ESPERA_ORDEM ? k : n_filhos - 1 - k;
+      sprintf(rot, "pid_%d", i);
+      instr(&a, "", "cargm", rot);
+      instr(&a, "", "trax", NULL);
+      instr(&a, "", "cargi", "SO_ESPERA_PROC");
+      instr(&a, "", "chamas", NULL);
+    }
+  }
+
+  // morre
+  instr(&a, "", "cargi", "0");
+  instr(&a, "", "trax", NULL);
+  instr(&a, "", "cargi", "SO_MATA_PROC");
+  instr(&a, "", "chamas", NULL);
+  fprintf(a.arq, "\n");
+
+  if (rajadas > 0) {
+    dado_espaco(&a, "rajadas", 1);
+    if (escreve) dado_espaco(&a, "cont_es", 1);
+    dado_valor(&a, "um", 1);
+  }
+  for (int i = 0; i < n_filhos; i++) {
+    char nome_maq[TAM_NOME + 5];
+    snprintf(nome_maq, sizeof(nome_maq), "%s.maq", filhos[i]);
+    sprintf(rot, "pid_%d", i);
+    sprintf(rot2, "nome_%d", i);
+    dado_espaco(&a, rot, 1);
+    dado_string(&a, rot2, nome_maq);
+  }
+
+  fclose(a.arq);
+  return a.tam;
+}
+
+// GERAÇÃO DA CARGA
+
+// gera um programa e registra na lista; retorna o endereço do próximo
+static int gera(param_t *p, FILE *lista, int endereco, int trab, int filho,
+                int n_filhos, char filhos[][TAM_NOME])
+{
+  char nome[TAM_NOME];
+  nome_prog(p, trab, filho, nome);
+  int rajadas = trab < 0 ? 0 : p->rajadas;
+  char letra = trab < 0 ? '*' : 'a' + trab % 26;
+  int tam = gera_programa(p, nome, endereco, rajadas, letra, n_filhos, filhos);
+  fprintf(lista, "%s %d\n", nome, endereco);
+  // o próximo começa em um endereço redondo, para facilitar a leitura
+  return (endereco + tam + 9) / 10 * 10;
+}
+
+static void gera_carga(param_t *p)
+{
+  char nome_lista[TAM_NOME + 5];
+  snprintf(nome_lista, sizeof(nome_lista), "%s.lst", p->nome);
+  FILE *lista = fopen(nome_lista, "w");
+  if (lista == NULL) {
+    perror(nome_lista);
+    exit(1);
+  }
+
+  int n_max = p->trabalhadores > p->filhos ? p->trabalhadores : p->filhos;
+  char (*filhos)[TAM_NOME] = malloc(n_max * sizeof(*filhos) + 1);
+  if (filhos == NULL) {
+    perror("gera_carga");
+    exit(1);
+  }
+
+  int endereco = p->base;
+  for (int i = 0; i < p->trabalhadores; i++) {
+    nome_prog(p, i, -1, filhos[i]);
+  }
+  endereco = gera(p, lista, endereco, -1, -1, p->trabalhadores, filhos);
+  for (int i = 0; i < p->trabalhadores; i++) {
+    for (int j = 0; j < p->filhos; j++) {
+      nome_prog(p, i, j, filhos[j]);
+    }
+    endereco = gera(p, lista, endereco, i, -1, p->filhos, filhos);
+    for (int j = 0; j < p->filhos; j++) {
+      endereco = gera(p, lista, endereco, i, j, 0, NULL);
+    }
+  }
+  free(filhos);
+  fclose(lista);
+
+  int n_procs = 1 + p->trabalhadores * (1 + p->filhos);
+  printf("%d programas em %d-%d, listados em %s\n", n_procs, p->base,
+         endereco - 1, nome_lista);
+  printf("execute com: ./main -M %d -i %s_init.maq\n", endereco, p->nome);
+}
+
+static void uso(char *nome)
+{
+  fprintf(stderr, "uso: %s [-p nome] [-b base] [-k trabalhadores] [-f filhos]"
+                  " [-r rajadas] [-c voltas]\n"
+                  "       [-e rajadas] [-w ordem|inversa|nenhuma]\n", nome);
+  fprintf(stderr, "  -p  prefixo dos arquivos gerados (padrão 'carga')\n");
+  fprintf(stderr, "  -b  endereço de carga do primeiro programa (padrão 10000)\n");
+  fprintf(stderr, "  -k  número de trabalhadores criados pelo processo inicial (padrão 10)\n");
+  fprintf(stderr, "  -f  número de filhos criados por cada trabalhador (padrão 0)\n");
+  fprintf(stderr, "  -r  rajadas de CPU de cada trabalhador e filho (padrão 10)\n");
+  fprintf(stderr, "  -c  voltas do laço em cada rajada, 2 instruções cada (padrão 1000)\n");
+  fprintf(stderr, "  -e  escreve um caractere a cada tantas rajadas, 0 para nunca (padrão 1)\n");
+  fprintf(stderr, "  -w  ordem em que os pais esperam os filhos: na ordem de criação\n"
+                  "      (padrão), na inversa, ou nenhuma (morrem sem esperar)\n");
+  exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+  param_t p = {
+    .nome = "carga",
+    .base = 10000,
+    .trabalhadores = 10,
+    .filhos = 0,
+    .rajadas = 10,
+    .tam_rajada = 1000,
+    .es_a_cada = 1,
+    .espera = ESPERA_ORDEM,
+  };
+  int c;
+  while ((c = getopt(argc, argv, "p:b:k:f:r:c:e:w:")) != -1) {
+    switch (c) {
+      case 'p': p.nome = optarg; break;
+      case 'b': p.base = atoi(optarg); break;
+      case 'k': p.trabalhadores = atoi(optarg); break;
+      case 'f': p.filhos = atoi(optarg); break;
+      case 'r': p.rajadas = atoi(optarg); break;
+      case 'c': p.tam_rajada = atoi(optarg); break;
+      case 'e': p.es_a_cada = atoi(optarg); break;
+      case 'w':
+        if (strcmp(optarg, "ordem") == 0) {
+          p.espera = ESPERA_ORDEM;
+        } else if (strcmp(optarg, "inversa") == 0) {
+          p.espera = ESPERA_INVERSA;
+        } else if (strcmp(optarg, "nenhuma") == 0) {
+          p.espera = ESPERA_NENHUMA;
+        } else {
+          uso(argv[0]);
+        }
+        break;
+      default:
+        uso(argv[0]);
+    }
+  }
+  if (optind < argc || p.base < 0 || p.trabalhadores < 0 || p.filhos < 0
+      || p.rajadas < 0 || p.tam_rajada < 1 || p.es_a_cada < 0) {
+    uso(argv[0]);
+  }
+  gera_carga(&p);
+  return 0;
+}
@@ -0,0 +1,66 @@
+// gera_hash.c
+// gera a tabela de hash perfeito dos nomes das instruções (instrucao_hash.h)
+// simulador de computador
+// so24b
+
+// procura um multiplicador e um tamanho de tabela para os quais a função
+//   instrucao_hash não tem colisão entre os nomes de todos os opcodes, e
+//   imprime a tabela correspondente, para ser incluída por instrucao.c
+// é ligado com uma versão de instrucao.c compilada com GERA_HASH, que não
+//   depende da tabela
+
+#include "instrucao.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#define MAX_TAM  1024
+#define MAX_MULT 1000
+
+// preenche 'tabela' com o opcode de cada posição (ou -1), usando o
+//   multiplicador 'mult' e o tamanho 'tam'
+// retorna false se houver colisão
+static bool tenta(unsigned mult, unsigned tam, int tabela[])
+{
+  for (int i = 0; i < tam; i++) {
+    tabela[i] = -1;
+  }
+  for (int opcode = 0; opcode < N_OPCODE; opcode++) {
+    unsigned h = instrucao_hash(instrucao_nome(opcode), mult, tam);
+    if (tabela[h] != -1) return false;
+    tabela[h] = opcode;
+  }
+  return true;
+}
+
+static void imprime(unsigned mult, unsigned tam, int tabela[])
+{
+  printf("// instrucao_hash.h\n");
+  printf("// tabela de hash perfeito dos nomes das instruções\n");
+  printf("// gerado por gera_hash -- não altere, altere instrucao.c\n\n");
+  printf("#define HASH_MULT %u\n", mult);
+  printf("#define HASH_TAM %u\n\n", tam);
+  printf("// opcode do nome com cada valor de hash (ou -1)\n");
+  printf("static const signed char hash_opcodes[HASH_TAM] = {");
+  for (int i = 0; i < tam; i++) {
+    if (i % 16 == 0) printf("\n ");
+    printf(" %d,", tabela[i]);
+  }
+  printf("\n};\n");
+}
+
+int main(void)
+{
+  int tabela[MAX_TAM];
+  // o menor tamanho de tabela possível, com o menor multiplicador
+  for (unsigned tam = N_OPCODE; tam <= MAX_TAM; tam++) {
+    for (unsigned mult = 1; mult < MAX_MULT; mult++) {
+      if (tenta(mult, tam, tabela)) {
+        imprime(mult, tam, tabela);
+        return 0;
+      }
+    }
+  }
+  fprintf(stderr, "ERRO: não foi encontrado um hash perfeito\n");
+  return 1;
+}
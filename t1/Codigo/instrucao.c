@@ -4,78 +4,130 @@
 // so24b
 
 #include "instrucao.h"
+#ifndef GERA_HASH
+// tabela de hash dos nomes, gerada por gera_hash (ver o Makefile)
+#include "instrucao_hash.h"
+#endif
 
 #include <stddef.h>
 #include <string.h>
+#include <ctype.h>
 
-struct {
+// nome e número de argumentos de cada opcode, indexada pelo opcode
+static struct {
   char *nome;
   int num_args;
-  opcode_t opcode;
-} instrucoes[] = {
-  { "NOP",    0,  NOP    },
-  { "PARA",   0,  PARA   },
-  { "CARGI",  1,  CARGI  },
-  { "CARGM",  1,  CARGM  },
-  { "CARGX",  1,  CARGX  },
-  { "ARMM",   1,  ARMM   },
-  { "ARMX",   1,  ARMX   },
-  { "TRAX",   0,  TRAX   },
-  { "CPXA",   0,  CPXA   },
-  { "INCX",   0,  INCX   },
-  { "SOMA",   1,  SOMA   },
-  { "SUB",    1,  SUB    },
-  { "MULT",   1,  MULT   },
-  { "DIV",    1,  DIV    },
-  { "RESTO",  1,  RESTO  },
-  { "NEG",    0,  NEG    },
-  { "DESV",   1,  DESV   },
-  { "DESVZ",  1,  DESVZ  },
-  { "DESVNZ", 1,  DESVNZ },
-  { "DESVN",  1,  DESVN  },
-  { "DESVP",  1,  DESVP  },
-  { "CHAMA",  1,  CHAMA  },
-  { "RET",    1,  RET    },
-  { "LE",     1,  LE     },
-  { "ESCR",   1,  ESCR   },
-  { "RETI",   0,  RETI   },
-  { "CHAMAC", 0,  CHAMAC },
-  { "CHAMAS", 0,  CHAMAS },
+} instrucoes[N_OPCODE] = {
+  [NOP]    = { "NOP",    0 },
+  [PARA]   = { "PARA",   0 },
+  [CARGI]  = { "CARGI",  1 },
+  [CARGM]  = { "CARGM",  1 },
+  [CARGX]  = { "CARGX",  1 },
+  [ARMM]   = { "ARMM",   1 },
+  [ARMX]   = { "ARMX",   1 },
+  [TRAX]   = { "TRAX",   0 },
+  [CPXA]   = { "CPXA",   0 },
+  [INCX]   = { "INCX",   0 },
+  [SOMA]   = { "SOMA",   1 },
+  [SUB]    = { "SUB",    1 },
+  [MULT]   = { "MULT",   1 },
+  [DIV]    = { "DIV",    1 },
+  [RESTO]  = { "RESTO",  1 },
+  [NEG]    = { "NEG",    0 },
+  [DESV]   = { "DESV",   1 },
+  [DESVZ]  = { "DESVZ",  1 },
+  [DESVNZ] = { "DESVNZ", 1 },
+  [DESVN]  = { "DESVN",  1 },
+  [DESVP]  = { "DESVP",  1 },
+  [CHAMA]  = { "CHAMA",  1 },
+  [RET]    = { "RET",    1 },
+  [LE]     = { "LE",     1 },
+  [ESCR]   = { "ESCR",   1 },
+  [RETI]   = { "RETI",   0 },
+  [CHAMAC] = { "CHAMAC", 0 },
+  [CHAMAS] = { "CHAMAS", 0 },
+  // superinstruções (os nomes não são aceitos pelo montador, que só gera
+  //   superinstruções pela fusão de instruções normais)
+  [TRAX_ARMM_CARGI_CHAMAS] = { "TRAX+ARMM+CARGI+CHAMAS", 0 },
+  [CARGM_SUB_DESVZ]        = { "CARGM+SUB+DESVZ",        1 },
+  [TRAX_CARGM_TRAX_RET]    = { "TRAX+CARGM+TRAX+RET",    0 },
   // pseudo-instrucoes
-  { "VALOR",  1,  VALOR  },
-  { "STRING", 1,  STRING },
-  { "ESPACO", 1,  ESPACO },
-  { "DEFINE", 1,  DEFINE },
+  [VALOR]  = { "VALOR",  1 },
+  [STRING] = { "STRING", 1 },
+  [ESPACO] = { "ESPACO", 1 },
+  [DEFINE] = { "DEFINE", 1 },
 };
 
+// as instruções que compõem cada superinstrução, indexada pelo opcode
+//   (n é 0 para as instruções que não são superinstruções)
+static struct {
+  int n;
+  opcode_t componentes[MAX_COMPONENTES];
+} superinstrucoes[N_OPCODE] = {
+  [TRAX_ARMM_CARGI_CHAMAS] = { 4, { TRAX, ARMM, CARGI, CHAMAS } },
+  [CARGM_SUB_DESVZ]        = { 3, { CARGM, SUB, DESVZ }         },
+  [TRAX_CARGM_TRAX_RET]    = { 4, { TRAX, CARGM, TRAX, RET }    },
+};
+
+static bool opcode_valido(int opcode)
+{
+  return opcode >= 0 && opcode < N_OPCODE;
+}
+
+unsigned instrucao_hash(char *nome, unsigned mult, unsigned tam)
+{
+  unsigned h = 0;
+  for (; *nome != '\0'; nome++) {
+    h = h * mult + toupper((unsigned char)*nome);
+  }
+  return h % tam;
+}
+
+#ifndef GERA_HASH
 opcode_t instrucao_opcode(char *nome)
 {
   if (nome == NULL) return -1;
-  for (int i=0; i<N_OPCODE; i++) {
-    if (strcasecmp(instrucoes[i].nome, nome) == 0) {
-      return instrucoes[i].opcode;
-    }
+  // o hash é perfeito para os nomes conhecidos; qualquer outro nome cai em
+  //   uma posição vazia ou na de um nome diferente
+  int opcode = hash_opcodes[instrucao_hash(nome, HASH_MULT, HASH_TAM)];
+  if (opcode < 0 || strcasecmp(instrucoes[opcode].nome, nome) != 0) {
+    return -1;
   }
-  return -1;
+  return opcode;
 }
+#endif
 
 char *instrucao_nome(int opcode)
 {
-  for (int i=0; i<N_OPCODE; i++) {
-    if (instrucoes[i].opcode == opcode) {
-      return instrucoes[i].nome;
-    }
-  }
-  return NULL;
+  if (!opcode_valido(opcode)) return NULL;
+  return instrucoes[opcode].nome;
 }
 
 int instrucao_num_args(int opcode)
 {
-  for (int i=0; i<N_OPCODE; i++) {
-    if (instrucoes[i].opcode == opcode) {
-      return instrucoes[i].num_args;
-    }
+  if (!opcode_valido(opcode)) return -1;
+  return instrucoes[opcode].num_args;
+}
+
+bool instrucao_acessa_mem_A1(int opcode)
+{
+  switch (opcode) {
+    case CARGM: case ARMM:  case SOMA: case SUB: case MULT: case DIV:
+    case RESTO: case CHAMA: case RET:
+      return true;
+    default:
+      return false;
   }
-  return -1;
 }
 
+int instrucao_num_componentes(int opcode)
+{
+  if (!opcode_valido(opcode) || superinstrucoes[opcode].n == 0) return 1;
+  return superinstrucoes[opcode].n;
+}
+
+int instrucao_componente(int opcode, int i)
+{
+  if (!opcode_valido(opcode) || superinstrucoes[opcode].n == 0) return opcode;
+  return superinstrucoes[opcode].componentes[i];
+}
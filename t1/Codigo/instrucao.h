@@ -6,6 +6,8 @@
 #ifndef INSTRUCAO_H
 #define INSTRUCAO_H
 
+#include <stdbool.h>
+
 // As instruções implementadas pelo simumador e as pseudo instruções do
 //   montador
 // As pseudo-instruções, processadas pelo montador e que não geram código são:
@@ -49,6 +51,17 @@ typedef enum {
   CHAMAS = 25, // 1   chama sistema          causa interrupção IRQ_SISTEMA
   RETI   = 26, // 1   retorno de interrupção restaura estado da CPU
   CHAMAC = 27, // 1   chama função C         simula código compilado
+  // superinstruções, geradas pelo montador com a opção -f no lugar de
+  //   sequências comuns de instruções
+  // o opcode da superinstrução substitui o opcode da primeira instrução da
+  //   sequência, o resto da sequência fica inalterado na memória; o tamanho
+  //   (#arg) é o da primeira instrução
+  // executar a superinstrução equivale a executar a sequência; a CPU pode
+  //   também executar só a primeira instrução (passo a passo, por exemplo), e
+  //   continuar com as demais, que estão intactas
+  TRAX_ARMM_CARGI_CHAMAS = 28, // 1   trax; armm A1; cargi B1; chamas
+  CARGM_SUB_DESVZ        = 29, // 2   cargm A1; sub B1; desvz C1
+  TRAX_CARGM_TRAX_RET    = 30, // 1   trax; cargm A1; trax; ret B1
   // pseudo-instruções
   VALOR,       // inicializa próxima posição de memória
   STRING,      // inicializa próximas posições de memória
@@ -57,6 +70,12 @@ typedef enum {
   N_OPCODE
 } opcode_t;
 
+// as superinstruções são os opcodes entre PRIMEIRA_SUPERINSTRUCAO e VALOR-1
+#define PRIMEIRA_SUPERINSTRUCAO TRAX_ARMM_CARGI_CHAMAS
+
+// número máximo de instruções em uma superinstrução
+#define MAX_COMPONENTES 4
+
 // retorna o opcode do nome
 opcode_t instrucao_opcode(char *nome);
 
@@ -66,4 +85,21 @@ char *instrucao_nome(int opcode);
 // retorna o número de argumentos do opcode
 int instrucao_num_args(int opcode);
 
+// função de hash dos nomes das instruções (sem diferenciar maiúsculas de
+//   minúsculas), com o multiplicador e o tamanho da tabela
+// usada por instrucao_opcode, com os parâmetros escolhidos por gera_hash
+unsigned instrucao_hash(char *nome, unsigned mult, unsigned tam);
+
+// retorna true se a instrução acessa a memória no endereço dado pelo seu
+//   argumento (sem indexação)
+bool instrucao_acessa_mem_A1(int opcode);
+
+// retorna o número de instruções que compõem o opcode (1 se não for uma
+//   superinstrução)
+int instrucao_num_componentes(int opcode);
+
+// retorna o opcode da instrução 'i' da sequência que compõe o opcode
+//   (para uma instrução normal, a única é ela mesma)
+int instrucao_componente(int opcode, int i);
+
 #endif // INSTRUCAO_H
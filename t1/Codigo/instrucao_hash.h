@@ -0,0 +1,15 @@
+// instrucao_hash.h
+// tabela de hash perfeito dos nomes das instruções
+// gerado por gera_hash -- não altere, altere instrucao.c
+
+#define HASH_MULT 436
+#define HASH_TAM 80
+
+// opcode do nome com cada valor de hash (ou -1)
+static const signed char hash_opcodes[HASH_TAM] = {
+  -1, -1, -1, -1, 4, 23, 19, 25, 20, -1, -1, 33, 0, -1, 31, -1,
+  -1, -1, 17, -1, 9, 21, -1, -1, -1, -1, -1, -1, 7, -1, 24, 14,
+  -1, -1, 18, -1, 12, -1, -1, 28, 22, 1, 13, 15, -1, -1, -1, -1,
+  -1, 8, 16, -1, -1, 10, 11, -1, 30, 26, -1, -1, -1, -1, -1, -1,
+  -1, 5, 29, -1, -1, 2, -1, 27, -1, 3, -1, -1, 6, 34, -1, 32,
+};
@@ -7,37 +7,58 @@
 #include "memoria.h"
 #include "cpu.h"
 #include "relogio.h"
+#include "pic.h"
 #include "console.h"
 #include "terminal.h"
 #include "es.h"
 #include "dispositivos.h"
 #include "so.h"
+#include "programa.h"
+#include "traco.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
 
 // constantes
-#define MEM_TAM 10000        // tamanho da memória principal
+#define MEM_TAM 10000        // tamanho padrão da memória principal
+#define LOTE_MS_PADRAO 100   // intervalo padrão de atualização da tela em lote
+#define N_TERMINAIS 4        // terminais 'A' a 'D'
 
 // estrutura com os componentes do computador simulado
 typedef struct {
   mem_t *mem;
   cpu_t *cpu;
   relogio_t *relogio;
+  pic_t *pic;
   console_t *console;
   es_t *es;
   controle_t *controle;
 } hardware_t;
 
-static void cria_hardware(hardware_t *hw)
+static void cria_hardware(hardware_t *hw, bool usa_tela, int tam_mem)
 {
   // cria a memória
-  hw->mem = mem_cria(MEM_TAM);
+  hw->mem = mem_cria(tam_mem);
 
   // cria dispositivos de E/S
-  hw->console = console_cria();
+  hw->console = console_cria(usa_tela);
   hw->relogio = relogio_cria();
 
+  // cria o controlador de interrupções e liga os dispositivos a ele
+  // o relógio mantém o pedido enquanto o SO não desliga o sinalizador; os
+  //   terminais pedem a cada mudança de estado
+  hw->pic = pic_cria();
+  pic_define_modo(hw->pic, IRQ_TECLADO, PIC_BORDA);
+  pic_define_modo(hw->pic, IRQ_TELA, PIC_BORDA);
+  relogio_conecta_pic(hw->relogio, hw->pic);
+  for (char t = 'A'; t <= 'D'; t++) {
+    terminal_conecta_pic(console_terminal(hw->console, t), hw->pic);
+  }
+
   // cria o controlador de E/S e registra os dispositivos
   //   por exemplo, o dispositivo 8 do controlador de E/S (e da CPU) será o
   //   dispositivo 0 do relógio (que é o contador de instruções)
@@ -67,18 +88,31 @@ static void cria_hardware(hardware_t *hw)
   es_registra_dispositivo(hw->es, D_TERM_D_TECLADO_OK , terminal, 1, terminal_leitura, NULL);
   es_registra_dispositivo(hw->es, D_TERM_D_TELA       , terminal, 2, NULL, terminal_escrita);
   es_registra_dispositivo(hw->es, D_TERM_D_TELA_OK    , terminal, 3, terminal_leitura, NULL);
+  // o teclado e a tela dos terminais também aceitam leitura e escrita em bloco
+  es_registra_leitura_bloco(hw->es, D_TERM_A_TECLADO, terminal_leitura_bloco);
+  es_registra_leitura_bloco(hw->es, D_TERM_B_TECLADO, terminal_leitura_bloco);
+  es_registra_leitura_bloco(hw->es, D_TERM_C_TECLADO, terminal_leitura_bloco);
+  es_registra_leitura_bloco(hw->es, D_TERM_D_TECLADO, terminal_leitura_bloco);
+  es_registra_escrita_bloco(hw->es, D_TERM_A_TELA, terminal_escrita_bloco);
+  es_registra_escrita_bloco(hw->es, D_TERM_B_TELA, terminal_escrita_bloco);
+  es_registra_escrita_bloco(hw->es, D_TERM_C_TELA, terminal_escrita_bloco);
+  es_registra_escrita_bloco(hw->es, D_TERM_D_TELA, terminal_escrita_bloco);
   // lê relógio virtual, relógio real
   es_registra_dispositivo(hw->es, D_RELOGIO_INSTRUCOES, hw->relogio, 0, relogio_leitura, NULL);
   es_registra_dispositivo(hw->es, D_RELOGIO_REAL      , hw->relogio, 1, relogio_leitura, NULL);
   es_registra_dispositivo(hw->es, D_RELOGIO_TIMER     , hw->relogio, 2, relogio_leitura, relogio_escrita);
   es_registra_dispositivo(hw->es, D_RELOGIO_INTERRUPCAO,hw->relogio, 3, relogio_leitura, relogio_escrita);
+  // lê interrupções pendentes, lê e altera a máscara de interrupções
+  es_registra_dispositivo(hw->es, D_PIC_PENDENTES     , hw->pic, 0, pic_leitura, NULL);
+  es_registra_dispositivo(hw->es, D_PIC_MASCARA       , hw->pic, 1, pic_leitura, pic_escrita);
 
   // cria a unidade de execução e inicializa com a memória e o controlador de E/S
   hw->cpu = cpu_cria(hw->mem, hw->es);
 
   // cria o controlador da CPU e inicializa com a unidade de execução, a console e
-  //   o relógio
-  hw->controle = controle_cria(hw->cpu, hw->console, hw->relogio);
+  //   o relógio; as interrupções dos dispositivos chegam pelo controlador de
+  //   interrupções
+  hw->controle = controle_cria(hw->cpu, hw->console, hw->relogio, hw->pic);
 }
 
 static void destroi_hardware(hardware_t *hw)
@@ -87,25 +121,288 @@ static void destroi_hardware(hardware_t *hw)
   cpu_destroi(hw->cpu);
   es_destroi(hw->es);
   relogio_destroi(hw->relogio);
+  pic_destroi(hw->pic);
   console_destroi(hw->console);
   mem_destroi(hw->mem);
 }
 
-int main()
+// opções de execução, vindas da linha de comando
+typedef struct {
+  bool em_lote;
+  int lote_instrucoes;
+  int lote_ms;
+  cpu_motor_t motor;
+  int tam_mem;
+  int orcamento_cache;  // -1 para manter o padrão do SO
+  bool sem_tela;
+  bool redesenho_completo;
+  char *programa_inicial;  // NULL para o padrão do SO
+  char *programa_sem_so;   // se não for NULL, executa esse programa sem SO
+  escalonador_t escalonador;
+  int latencia_cfs;        // 0 para manter o padrão do SO
+  int granularidade_cfs;
+  // arquivos de entrada e de saída de cada terminal (ou NULL)
+  char *entrada[N_TERMINAIS];
+  int ritmo_entrada[N_TERMINAIS];
+  char *saida[N_TERMINAIS];
+} opcoes_t;
+
+static void uso(char *nome)
+{
+  fprintf(stderr, "uso: %s [-l] [-n instruções] [-t ms] [-m motor] [-M palavras] [-c bytes]\n"
+                  "       [-H] [-R] [-e t:arquivo[:ritmo]]... [-s t:arquivo]...\n"
+                  "       [-v nível[:subsistemas]] [-p escalonador] [-i programa | -x programa]\n", nome);
+  fprintf(stderr, "  -l  executa em lote, sem esperar comandos do operador\n");
+  fprintf(stderr, "  -n  em lote, atualiza a tela a cada tantas instruções\n");
+  fprintf(stderr, "  -t  em lote, atualiza a tela a cada tantos ms (padrão %d)\n",
+          LOTE_MS_PADRAO);
+  fprintf(stderr, "      com -n 0 -t 0, a tela não é atualizada durante a execução\n");
+  fprintf(stderr, "  -m  motor de execução da CPU: 'switch' (padrão), 'encadeado' ou 'blocos'\n");
+  fprintf(stderr, "  -M  tamanho da memória principal, em palavras (padrão e mínimo %d)\n",
+          MEM_TAM);
+  fprintf(stderr, "  -c  orçamento em bytes da cache de programas do SO (0 desabilita)\n");
+  fprintf(stderr, "  -H  executa sem a tela (implica -l -n 0 -t 0); mensagens vão para a\n"
+                  "      saída padrão\n");
+  fprintf(stderr, "  -R  redesenha toda a tela a cada atualização, sem limite de frequência\n"
+                  "      (como era antes; para comparar o custo do desenho)\n");
+  fprintf(stderr, "  -e  a entrada do terminal t ('A' a 'D') vem do arquivo (ou pipe), um\n"
+                  "      caractere a cada 'ritmo' instruções (padrão 100)\n");
+  fprintf(stderr, "  -s  a saída do terminal t é gravada no arquivo\n");
+  fprintf(stderr, "  -v  mensagens do SO mostradas: nível 'erro', 'info', 'depura' (padrão) ou\n"
+                  "      'rastro', e subsistemas separados por vírgula, entre 'geral', 'irq',\n"
+                  "      'esc', 'chamada' e 'carga' (padrão todos); ex: -v rastro:esc,irq\n");
+  fprintf(stderr, "  -p  escalonador de processos do SO: 'normal' (padrão), 'rr', 'prioridade',\n"
+                  "      'mlfq' ou 'cfs[:latência[:granularidade]]' (em unidades de tempo do\n"
+                  "      relógio)\n");
+  fprintf(stderr, "  -i  programa do processo inicial do SO (padrão init.maq)\n");
+  fprintf(stderr, "  -x  executa o programa sem SO, em modo supervisor, com acesso direto\n"
+                  "      aos dispositivos (como ex2, ex4, ex5, ex6)\n");
+  exit(1);
+}
+
+// separa o terminal no início de "t:arquivo", retornando seu número e
+//   apontando *pnome para o arquivo; -1 se inválido
+static int pega_terminal(char *arg, char **pnome)
+{
+  int t = toupper(arg[0]) - 'A';
+  if (t < 0 || t >= N_TERMINAIS || arg[1] != ':' || arg[2] == '\0') return -1;
+  *pnome = &arg[2];
+  return t;
+}
+
+// separa o ritmo no final de "arquivo:ritmo", se tiver; 0 se não tiver
+static int pega_ritmo(char *nome)
+{
+  char *p = strrchr(nome, ':');
+  if (p == NULL || p[1] == '\0' || strspn(p + 1, "0123456789") != strlen(p + 1)) {
+    return 0;
+  }
+  *p = '\0';
+  return atoi(p + 1);
+}
+
+static void pega_opcoes(int argc, char *argv[argc], opcoes_t *op)
+{
+  op->em_lote = false;
+  op->lote_instrucoes = 0;
+  op->lote_ms = LOTE_MS_PADRAO;
+  op->motor = CPU_MOTOR_SWITCH;
+  op->tam_mem = MEM_TAM;
+  op->orcamento_cache = -1;
+  op->sem_tela = false;
+  op->redesenho_completo = false;
+  op->programa_inicial = NULL;
+  op->programa_sem_so = NULL;
+  op->escalonador = ESCALONADOR_NORMAL;
+  op->latencia_cfs = 0;
+  op->granularidade_cfs = 0;
+  for (int t = 0; t < N_TERMINAIS; t++) {
+    op->entrada[t] = NULL;
+    op->saida[t] = NULL;
+  }
+  int c, t;
+  char *nome;
+  while ((c = getopt(argc, argv, "ln:t:m:M:c:HRe:s:v:p:i:x:")) != -1) {
+    switch (c) {
+      case 'l':
+        op->em_lote = true;
+        break;
+      case 'n':
+        op->lote_instrucoes = atoi(optarg);
+        break;
+      case 't':
+        op->lote_ms = atoi(optarg);
+        break;
+      case 'm':
+        if (strcmp(optarg, "switch") == 0) {
+          op->motor = CPU_MOTOR_SWITCH;
+        } else if (strcmp(optarg, "encadeado") == 0) {
+          op->motor = CPU_MOTOR_ENCADEADO;
+        } else if (strcmp(optarg, "blocos") == 0) {
+          op->motor = CPU_MOTOR_BLOCOS;
+        } else {
+          uso(argv[0]);
+        }
+        break;
+      case 'M':
+        op->tam_mem = atoi(optarg);
+        if (op->tam_mem < MEM_TAM) uso(argv[0]);
+        break;
+      case 'c':
+        op->orcamento_cache = atoi(optarg);
+        if (op->orcamento_cache < 0) uso(argv[0]);
+        break;
+      case 'H':
+        op->sem_tela = true;
+        break;
+      case 'p':
+        if (strcmp(optarg, "normal") == 0) {
+          op->escalonador = ESCALONADOR_NORMAL;
+        } else if (strcmp(optarg, "rr") == 0) {
+          op->escalonador = ESCALONADOR_ROUND_ROBIN;
+        } else if (strcmp(optarg, "prioridade") == 0) {
+          op->escalonador = ESCALONADOR_ROUND_ROBIN_PRIORIDADE;
+        } else if (strcmp(optarg, "mlfq") == 0) {
+          op->escalonador = ESCALONADOR_MLFQ;
+        } else if (strncmp(optarg, "cfs", 3) == 0
+                   && (optarg[3] == '\0' || optarg[3] == ':')) {
+          op->escalonador = ESCALONADOR_CFS;
+          if (optarg[3] == ':') {
+            op->granularidade_cfs = pega_ritmo(&optarg[4]);
+            if (strchr(&optarg[4], ':') != NULL) uso(argv[0]);
+            op->latencia_cfs = atoi(&optarg[4]);
+            if (op->latencia_cfs <= 0) uso(argv[0]);
+          }
+        } else {
+          uso(argv[0]);
+        }
+        break;
+      case 'i':
+        op->programa_inicial = optarg;
+        break;
+      case 'x':
+        op->programa_sem_so = optarg;
+        break;
+      case 'v':
+        if (!traco_interpreta(optarg)) uso(argv[0]);
+        break;
+      case 'R':
+        op->redesenho_completo = true;
+        break;
+      case 'e':
+        t = pega_terminal(optarg, &nome);
+        if (t < 0) uso(argv[0]);
+        op->ritmo_entrada[t] = pega_ritmo(nome);
+        op->entrada[t] = nome;
+        break;
+      case 's':
+        t = pega_terminal(optarg, &nome);
+        if (t < 0) uso(argv[0]);
+        op->saida[t] = nome;
+        break;
+      default:
+        uso(argv[0]);
+    }
+  }
+  if (optind < argc) uso(argv[0]);
+  if (op->programa_inicial != NULL && op->programa_sem_so != NULL) uso(argv[0]);
+  if (op->sem_tela) {
+    // sem tela não tem operador para mandar executar nem tela a atualizar
+    op->em_lote = true;
+    op->lote_instrucoes = 0;
+    op->lote_ms = 0;
+  }
+}
+
+// liga os terminais aos arquivos pedidos nas opções
+static void liga_arquivos_dos_terminais(hardware_t *hw, opcoes_t *op)
+{
+  for (int t = 0; t < N_TERMINAIS; t++) {
+    char id = 'A' + t;
+    if (op->entrada[t] != NULL
+        && !console_entrada_de_arquivo(hw->console, id, op->entrada[t],
+                                       op->ritmo_entrada[t])) {
+      console_printf("Não consegui abrir '%s' para o terminal %c",
+                     op->entrada[t], id);
+    }
+    if (op->saida[t] != NULL
+        && !console_saida_para_arquivo(hw->console, id, op->saida[t])) {
+      console_printf("Não consegui criar '%s' para o terminal %c",
+                     op->saida[t], id);
+    }
+  }
+}
+
+// carrega o programa 'nome' na memória e faz a CPU executá-lo diretamente,
+//   sem SO
+// sem SO não tem quem trate interrupções: elas ficam todas mascaradas, e a
+//   simulação termina quando o programa parar (instrução PARA)
+static bool prepara_execucao_sem_so(hardware_t *hw, char *nome)
+{
+  programa_t *prog = prog_cria(nome);
+  if (prog == NULL) {
+    console_printf("Erro na leitura do programa '%s'", nome);
+    return false;
+  }
+  int end_ini = prog_end_carga(prog);
+  err_t err = mem_escreve_bloco(hw->mem, end_ini, prog_tamanho(prog), prog_dados(prog));
+  int inicio = prog_end_inicio(prog);
+  prog_destroi(prog);
+  if (err != ERR_OK) {
+    console_printf("Erro na carga do programa '%s' na memória", nome);
+    return false;
+  }
+  pic_define_mascara(hw->pic, ~0u);
+  cpu_inicia(hw->cpu, inicio);
+  console_printf("carga de '%s' em %d, execução sem SO a partir de %d",
+                 nome, end_ini, inicio);
+  return true;
+}
+
+int main(int argc, char *argv[argc])
 {
   hardware_t hw;
   so_t *so;
+  opcoes_t opcoes;
+
+  pega_opcoes(argc, argv, &opcoes);
 
   // cria o hardware
-  cria_hardware(&hw);
-  // cria o sistema operacional
-  so = so_cria(hw.cpu, hw.mem, hw.es, hw.console);
-  
+  cria_hardware(&hw, !opcoes.sem_tela, opcoes.tam_mem);
+  liga_arquivos_dos_terminais(&hw, &opcoes);
+  console_define_redesenho_completo(hw.console, opcoes.redesenho_completo);
+  cpu_define_motor(hw.cpu, opcoes.motor);
+  if (opcoes.em_lote) {
+    controle_define_lote(hw.controle, opcoes.lote_instrucoes, opcoes.lote_ms);
+    console_define_espera_no_fim(hw.console, false);
+    // em lote o teclado é consultado só de vez em quando, não tem por que
+    //   esperar por uma tecla
+    console_define_espera_teclado(hw.console, 0);
+  }
+  if (opcoes.programa_sem_so != NULL) {
+    so = NULL;
+    if (!prepara_execucao_sem_so(&hw, opcoes.programa_sem_so)) {
+      destroi_hardware(&hw);
+      return 1;
+    }
+  } else {
+    // cria o sistema operacional
+    so = so_cria(hw.cpu, hw.mem, hw.es, hw.console);
+    if (opcoes.orcamento_cache >= 0) {
+      so_define_orcamento_cache(so, opcoes.orcamento_cache);
+    }
+    if (opcoes.programa_inicial != NULL) {
+      so_define_programa_inicial(so, opcoes.programa_inicial);
+    }
+    so_define_escalonador(so, opcoes.escalonador);
+    so_define_cfs(so, opcoes.latencia_cfs, opcoes.granularidade_cfs);
+  }
+
   // executa o laço principal do controlador
   controle_laco(hw.controle);
 
   // destroi tudo
-  so_destroi(so);
+  if (so != NULL) so_destroi(so);
   destroi_hardware(&hw);
 }
 
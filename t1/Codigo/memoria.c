@@ -6,14 +6,9 @@
 #include "memoria.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
-// tipo de dados para representar uma região de memória
-struct mem_t {
-  int tam;
-  int *conteudo;
-};
-
 mem_t *mem_cria(int tam)
 {
   mem_t *self;
@@ -24,6 +19,7 @@ mem_t *mem_cria(int tam)
   assert(self->conteudo != NULL);
 
   self->tam = tam;
+  self->observador = NULL;
 
   return self;
 }
@@ -43,29 +39,20 @@ int mem_tam(mem_t *self)
   return self->tam;
 }
 
-// função auxiliar, verifica se endereço é válido
-static err_t verifica_permissao(mem_t *self, int endereco)
+err_t mem_escreve_bloco(mem_t *self, int endereco, int n, const int *valores)
 {
-  if (endereco < 0 || endereco >= self->tam) {
-    return ERR_END_INV;
+  if (!mem_faixa_valida(self, endereco, n)) return ERR_END_INV;
+  memcpy(&self->conteudo[endereco], valores, n * sizeof(*valores));
+  if (self->observador != NULL) {
+    for (int i = 0; i < n; i++) {
+      self->observador(self->arg_observador, endereco + i);
+    }
   }
   return ERR_OK;
 }
 
-err_t mem_le(mem_t *self, int endereco, int *pvalor)
+void mem_define_observador(mem_t *self, mem_f_observador_t f, void *arg)
 {
-  err_t err = verifica_permissao(self, endereco);
-  if (err == ERR_OK) {
-    *pvalor = self->conteudo[endereco];
-  }
-  return err;
-}
-
-err_t mem_escreve(mem_t *self, int endereco, int valor)
-{
-  err_t err = verifica_permissao(self, endereco);
-  if (err == ERR_OK) {
-    self->conteudo[endereco] = valor;
-  }
-  return err;
+  self->observador = f;
+  self->arg_observador = arg;
 }
@@ -8,9 +8,26 @@
 
 #include "err.h"
 
-// tipo opaco que representa a memória
+#include <stdbool.h>
+#include <stddef.h>
+
+// tipo que representa a memória
 typedef struct mem_t mem_t;
 
+// tipo da função chamada a cada escrita bem sucedida na memória
+typedef void (*mem_f_observador_t)(void *arg, int endereco);
+
+// a estrutura só é visível aqui para que as funções de acesso possam ser
+//   expandidas em linha (ver abaixo); fora de memoria.c, não deve ser
+//   acessada diretamente
+struct mem_t {
+  int tam;
+  int *conteudo;
+  // quem deve ser avisado das escritas
+  mem_f_observador_t observador;
+  void *arg_observador;
+};
+
 // cria uma região de memória com capacidade para 'tam' valores (inteiros)
 // retorna um ponteiro para um descritor, que deverá ser usado em todas
 //   as operações sobre essa memória
@@ -23,12 +40,66 @@ void mem_destroi(mem_t *self);
 // retorna o tamanho da região de memória (número de valores que comporta)
 int mem_tam(mem_t *self);
 
+// retorna true se os 'n' endereços a partir de 'endereco' são válidos
+static inline bool mem_faixa_valida(mem_t *self, int endereco, int n)
+{
+  return endereco >= 0 && endereco <= self->tam - n;
+}
+
+// retorna o valor no endereço 'endereco', sem verificar o endereço
+// só pode ser usada se o endereço já foi verificado (com mem_faixa_valida)
+static inline int mem_le_rapido(mem_t *self, int endereco)
+{
+  return self->conteudo[endereco];
+}
+
+// coloca 'valor' no endereço 'endereco', sem verificar o endereço
+// só pode ser usada se o endereço já foi verificado (com mem_faixa_valida)
+static inline void mem_escreve_rapido(mem_t *self, int endereco, int valor)
+{
+  self->conteudo[endereco] = valor;
+  if (self->observador != NULL) {
+    self->observador(self->arg_observador, endereco);
+  }
+}
+
 // coloca na posição apontada por 'pvalor' o valor no endereço 'endereco'
 // retorna erro ERR_END_INV (e não altera '*pvalor') se endereço inválido
-err_t mem_le(mem_t *self, int endereco, int *pvalor);
+static inline err_t mem_le(mem_t *self, int endereco, int *pvalor)
+{
+  if (!mem_faixa_valida(self, endereco, 1)) return ERR_END_INV;
+  *pvalor = mem_le_rapido(self, endereco);
+  return ERR_OK;
+}
 
 // coloca 'valor' no endereço 'endereco' da memória
 // retorna erro ERR_END_INV se endereço inválido
-err_t mem_escreve(mem_t *self, int endereco, int valor);
+static inline err_t mem_escreve(mem_t *self, int endereco, int valor)
+{
+  if (!mem_faixa_valida(self, endereco, 1)) return ERR_END_INV;
+  mem_escreve_rapido(self, endereco, valor);
+  return ERR_OK;
+}
+
+// coloca os 'n' valores de 'valores' na memória, a partir de 'endereco'
+// retorna erro ERR_END_INV (e não altera a memória) se algum endereço for
+//   inválido
+err_t mem_escreve_bloco(mem_t *self, int endereco, int n, const int *valores);
+
+// retorna um ponteiro para os 'n' valores a partir de 'endereco', para
+//   transferências em bloco feitas diretamente da memória (como em DMA), ou
+//   NULL se algum endereço for inválido
+// o ponteiro só é válido até a próxima alteração na memória
+static inline const int *mem_faixa(mem_t *self, int endereco, int n)
+{
+  if (!mem_faixa_valida(self, endereco, n)) return NULL;
+  return &self->conteudo[endereco];
+}
+
+// define uma função a ser chamada (com o argumento 'arg') depois de cada
+//   alteração na memória, para quem mantém cópias derivadas do conteúdo
+//   (a CPU, para descartar instruções pré-decodificadas)
+// só existe um observador; NULL remove o observador
+void mem_define_observador(mem_t *self, mem_f_observador_t f, void *arg);
 
 #endif // MEMORIA_H
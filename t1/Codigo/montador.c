@@ -5,12 +5,14 @@
 
 // INCLUDES {{{1
 #include "instrucao.h"
+#include "programa.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 #include <ctype.h>
+#include <limits.h>
 
 // AUXILIARES {{{1
 // aborta o programa com uma mensagem de erro
@@ -38,20 +40,39 @@ bool tem_numero(char *s, int *num)
 
 // representa a memória do programa -- a saída do montador é colocada aqui
 
-#define MEM_TAM 10000    // aumentar para programas maiores
-int mem[MEM_TAM];
+// a memória é indexada pelo endereço final, e é alocada (e aumentada) de
+//   acordo com o maior endereço usado pelo programa (os programas gerados por
+//   gera_carga ficam depois dos 10000 endereços da memória padrão do
+//   simulador)
+#define MEM_TAM_INICIAL 10000
+int *mem;
+int mem_tam;            // número de posições alocadas em mem
 int mem_pos = 100;      // próxima posição livre da memória
 int mem_min = -1;       // menor endereço preenchido
 int mem_max = -1;       // maior endereço preenchido
 
 char *nome_fonte;   // nome do arquivo fonte a montar
+bool fundir;        // se deve gerar superinstruções (opção -f)
+bool binario;       // se deve gerar o formato binário (opção -b)
+
+// aumenta a memória para conter a posição 'pos'
+void mem_aumenta(int pos)
+{
+  int tam = mem_tam == 0 ? MEM_TAM_INICIAL : mem_tam;
+  while (tam <= pos) {
+    if (tam > INT_MAX / 2) erro_brabo("programa muito grande!");
+    tam *= 2;
+  }
+  mem = realloc(mem, tam * sizeof(*mem));
+  if (mem == NULL) erro_brabo("sem memória para o programa!");
+  mem_tam = tam;
+}
 
 // coloca um valor no final da memória
 void mem_insere(int val)
 {
-  if (mem_pos >= MEM_TAM-1) {
-    erro_brabo("programa muito grande! Aumente MEM_TAM no montador.");
-  }
+  if (mem_pos < 0) erro_brabo("endereço negativo!");
+  if (mem_pos >= mem_tam) mem_aumenta(mem_pos);
   if (mem_min == -1 || mem_pos < mem_min) mem_min = mem_pos;
   if (mem_max == -1 || mem_pos > mem_max) mem_max = mem_pos;
   mem[mem_pos++] = val;
@@ -82,11 +103,13 @@ void mem_imprime(void)
 // SÍMBOLOS {{{1
 
 // tabela com os símbolos (labels) já definidos pelo programa, e o valor (endereço) deles
+// os símbolos definidos com DEFINE não são endereços, e não são relocáveis
 
-#define SIMB_TAM 1000
+#define SIMB_TAM 10000   // o processo inicial gerado por gera_carga tem 2 por processo criado
 struct {
   char *nome;
   int valor;
+  bool endereco;
 } simbolo[SIMB_TAM];
 int simb_num;             // número d símbolos na tabela
 
@@ -101,8 +124,19 @@ int simb_valor(char *nome)
   return -1;
 }
 
+// retorna true se o símbolo existe e é um endereço (um label)
+bool simb_endereco(char *nome)
+{
+  for (int i=0; i<simb_num; i++) {
+    if (strcmp(nome, simbolo[i].nome) == 0) {
+      return simbolo[i].endereco;
+    }
+  }
+  return false;
+}
+
 // insere um novo símbolo na tabela
-void simb_novo(char *nome, int valor)
+void simb_novo(char *nome, int valor, bool endereco)
 {
   if (nome == NULL) return;
   if (simb_valor(nome) != -1) {
@@ -114,6 +148,7 @@ void simb_novo(char *nome, int valor)
   }
   simbolo[simb_num].nome = strdup(nome);
   simbolo[simb_num].valor = valor;
+  simbolo[simb_num].endereco = endereco;
   simb_num++;
 }
 
@@ -123,7 +158,7 @@ void simb_novo(char *nome, int valor)
 // tabela com referências a símbolos
 //   contém a linha e o endereço correspondente onde o símbolo foi referenciado
 
-#define REF_TAM 1000
+#define REF_TAM 10000    // e 4 referências por processo criado
 struct {
   char *nome;
   int linha;
@@ -161,6 +196,125 @@ void ref_resolve(void)
 
 
 
+// SAÍDA BINÁRIA {{{1
+
+// grava no formato binário (ver programa.h) o conteúdo da memória, os
+//   endereços das referências a labels (para relocação) e os labels
+void mem_grava_binario(void)
+{
+  int n_reloc = 0;
+  for (int i = 0; i < ref_num; i++) {
+    if (simb_endereco(ref[i].nome)) n_reloc++;
+  }
+  int n_simbolos = 0;
+  for (int i = 0; i < simb_num; i++) {
+    if (simbolo[i].endereco) n_simbolos++;
+  }
+  prog_cabecalho_t cab = {
+    .magico = PROG_MAGICO,
+    .carga = mem_min,
+    .tamanho = mem_max - mem_min + 1,
+    .inicio = mem_min,
+    .n_reloc = n_reloc,
+    .n_simbolos = n_simbolos,
+  };
+  fwrite(&cab, sizeof(cab), 1, stdout);
+  for (int end = mem_min; end <= mem_max; end++) {
+    int32_t valor = mem[end];
+    fwrite(&valor, sizeof(valor), 1, stdout);
+  }
+  for (int i = 0; i < ref_num; i++) {
+    if (!simb_endereco(ref[i].nome)) continue;
+    int32_t endereco = ref[i].endereco;
+    fwrite(&endereco, sizeof(endereco), 1, stdout);
+  }
+  for (int i = 0; i < simb_num; i++) {
+    if (!simbolo[i].endereco) continue;
+    prog_simbolo_t simb = { .valor = simbolo[i].valor };
+    strncpy(simb.nome, simbolo[i].nome, PROG_TAM_NOME - 1);
+    fwrite(&simb, sizeof(simb), 1, stdout);
+  }
+}
+
+
+// INSTRUÇÕES {{{1
+
+// tabela com as instruções montadas (só as instruções reais, não os dados),
+//   com o endereço e o opcode de cada uma, para a fusão
+
+struct instr {
+  int endereco;
+  int opcode;
+} *instr;
+int instr_tam;    // número de instruções que cabem na tabela
+int instr_num;    // número de instruções na tabela
+
+// insere uma instrução na tabela, aumentando-a se necessário
+void instr_nova(int endereco, int opcode)
+{
+  if (instr_num >= instr_tam) {
+    instr_tam = instr_tam == 0 ? MEM_TAM_INICIAL : instr_tam * 2;
+    instr = realloc(instr, instr_tam * sizeof(*instr));
+    if (instr == NULL) erro_brabo("sem memória para as instruções!");
+  }
+  instr[instr_num].endereco = endereco;
+  instr[instr_num].opcode = opcode;
+  instr_num++;
+}
+
+
+// FUSÃO {{{1
+
+// com a opção -f, as sequências de instruções que correspondem a uma
+//   superinstrução (ver instrucao.h) são fundidas: o opcode da primeira
+//   instrução é trocado pelo da superinstrução, e o resto fica igual
+// só são fundidas instruções contíguas na memória; um label no meio da
+//   sequência não atrapalha, quem desviar para lá executa as instruções
+//   normais que continuam na memória
+
+// retorna true se as instruções a partir de instr[i] formam a sequência da
+//   superinstrução 'super'
+bool casa_sequencia(int i, int super)
+{
+  int n = instrucao_num_componentes(super);
+  if (i + n > instr_num) return false;
+  for (int j = 0; j < n; j++) {
+    if (instr[i + j].opcode != instrucao_componente(super, j)) return false;
+    if (j == 0) continue;
+    int anterior = instr[i + j - 1].endereco
+                 + 1 + instrucao_num_args(instr[i + j - 1].opcode);
+    if (instr[i + j].endereco != anterior) return false;
+  }
+  return true;
+}
+
+// troca as sequências de instruções por superinstruções, e informa (na
+//   saída de erro) quantas foram geradas
+void funde_instrucoes(void)
+{
+  int fusoes[N_OPCODE] = { 0 };
+  int total = 0;
+  for (int i = 0; i < instr_num; i++) {
+    for (int super = PRIMEIRA_SUPERINSTRUCAO; super < VALOR; super++) {
+      if (casa_sequencia(i, super)) {
+        mem_altera(instr[i].endereco, super);
+        fusoes[super]++;
+        total++;
+        i += instrucao_num_componentes(super) - 1;
+        break;
+      }
+    }
+  }
+  fprintf(stderr, "%s: %d superinstruções", nome_fonte, total);
+  for (int super = PRIMEIRA_SUPERINSTRUCAO; super < VALOR; super++) {
+    if (fusoes[super] > 0) {
+      fprintf(stderr, ", %d %s", fusoes[super], instrucao_nome(super));
+    }
+  }
+  fprintf(stderr, "\n");
+}
+
+
 // MONTAGEM {{{1
 
 // realiza a montagem de uma instrução (gera o código para ela na memória),
@@ -195,6 +349,7 @@ void monta_instrucao(int linha, int opcode, char *arg)
     return;
   } else {
     // instrução real, coloca o opcode da instrução na memória
+    instr_nova(mem_pos, opcode);
     mem_insere(opcode);
   }
   if (num_args == 0) {
@@ -219,7 +374,7 @@ void monta_define(int linha, char *label, char *arg)
     fprintf(stderr, "ERRO: linha %d 'DEFINE' exige valor numérico\n", linha);
   } else {
     // tudo OK, define o símbolo
-    simb_novo(label, argn);
+    simb_novo(label, argn, false);
   }
 }
 
@@ -236,12 +391,13 @@ void monta_linha(int linha, char *label, char *instrucao, char *arg)
   
   // cria símbolo correspondente ao label, se for o caso
   if (label != NULL) {
-    simb_novo(label, mem_pos);
+    simb_novo(label, mem_pos, true);
   }
   
   // verifica a existência de instrução e número correto de argumentos
   if (instrucao == NULL) return;
-  if (opcode == -1) {
+  // superinstruções só são geradas pela fusão
+  if (opcode == -1 || (opcode >= PRIMEIRA_SUPERINSTRUCAO && opcode < VALOR)) {
     fprintf(stderr, "ERRO: linha %d: instrucao '%s' desconhecida\n",
                     linha, instrucao);
     return;
@@ -388,12 +544,16 @@ void verifica_args(int argc, char *argv[argc])
         fprintf(stderr, "ERRO: endereço inválido: '%s'\n", argv[argi]);
         exit(1);
       }
+    } else if (strcmp(argv[argi], "-f") == 0) {
+      fundir = true;
+    } else if (strcmp(argv[argi], "-b") == 0) {
+      binario = true;
     } else {
       nome_fonte = argv[argi];
     }
   }
   if (nome_fonte == NULL) {
-    fprintf(stderr, "ERRO: chame como '%s [-e end.inicial] nome_do_arquivo'\n",
+    fprintf(stderr, "ERRO: chame como '%s [-e end.inicial] [-f] [-b] nome_do_arquivo'\n",
             argv[0]);
     exit(1);
   }
@@ -403,7 +563,12 @@ int main(int argc, char *argv[argc])
 {
   verifica_args(argc, argv);
   monta_arquivo(nome_fonte);
-  mem_imprime();
+  if (fundir) funde_instrucoes();
+  if (binario) {
+    mem_grava_binario();
+  } else {
+    mem_imprime();
+  }
   return 0;
 }
 
@@ -12,6 +12,7 @@ prog     string 'p2  (média CPU, média E/S)
 ; chamadas de sistema (ver so.h)
 SO_LE          define 1
 SO_ESCR        define 2
+SO_ESCR_BLOCO  define 10
 SO_CRIA_PROC   define 7
 SO_MATA_PROC   define 8
 SO_ESPERA_PROC define 9
@@ -65,15 +66,25 @@ cada     valor CADA
 ene      valor N
 
 ; imprime a string que inicia em A (destroi X)
+; conta os caracteres e imprime todos com uma só chamada ao SO
 impstr   espaco 1
+         armm is_end
          trax
 impstr1
          cargx 0
          desvz impstrf
-         chama impch
          incx
          desv impstr1
-impstrf  ret impstr
+impstrf  cpxa
+         sub is_end
+         armm is_tam
+         cargi is_end
+         trax
+         cargi SO_ESCR_BLOCO
+         chamas
+         ret impstr
+is_end   espaco 1 ; descritor para SO_ESCR_BLOCO: endereço e tamanho
+is_tam   espaco 1
 
 ; função que chama o SO para imprimir o caractere em A
 ; retorna em A o código de erro do SO
@@ -89,25 +100,31 @@ impch    espaco 1
          ret impch
 impch_X  espaco 1 ; para salvar o valor de X
 
-; escreve o valor de A no terminal, em decimal
+; escreve o valor de A no terminal, em decimal, seguido de um espaço
+; os caracteres são montados em ei_buf e impressos com uma só chamada ao SO
+; não altera o valor de X
 impnum  espaco 1
         ; ei_num = A
         armm ei_num
+        ; ei_p = ei_buf
+        cargi ei_buf
+        armm ei_p
+        cargm ei_num
         ; if ei_num > 0 goto ei_pos
         desvp ei_pos
         ; if ei_num < 0 goto ei_neg
         desvn ei_neg
-        ; print '0'; goto ei_f
+        ; põe '0'; goto ei_f
         cargi '0'
-        chama impch
+        chama poech
         desv ei_f
 ei_neg
         ; ei_num = -ei_num
         neg
         armm ei_num
-        ; print '-'
+        ; põe '-'
         cargi '-'
-        chama impch
+        chama poech
 ei_pos
         ; faz ei_mul ser a maior potência de 10 <= ei_num
         ; ei_mul = 1
@@ -132,12 +149,12 @@ ei_2
         div dez
         armm ei_mul
 ei_3
-        ; print (ei_num/ei_mul) % 10 + '0'
+        ; põe (ei_num/ei_mul) % 10 + '0'
         cargm ei_num
         div ei_mul
         resto dez
         soma a_zero
-        chama impch
+        chama poech
         ; ei_mul /= 10
         cargm ei_mul
         div dez
@@ -145,12 +162,46 @@ ei_3
         ; if ei_mul > 0 goto ei_3
         desvp ei_3
 ei_f
-        ; print ' '
+        ; põe ' '
         cargi ' '
-        chama impch
+        chama poech
+        ; ei_tam = ei_p - ei_buf
+        cargm ei_p
+        sub ei_desc
+        armm ei_tam
+        ; imprime ei_buf, preservando X
+        trax
+        armm ei_X
+        cargi ei_desc
+        trax
+        cargi SO_ESCR_BLOCO
+        chamas
+        cargm ei_X
+        trax
         ; return
         ret impnum
 ei_num  espaco 1
 ei_mul  espaco 1
+ei_X    espaco 1
+ei_p    espaco 1 ; onde vai o próximo caractere em ei_buf
+ei_desc valor ei_buf ; descritor para SO_ESCR_BLOCO: endereço e tamanho
+ei_tam  espaco 1
+ei_buf  espaco 12
 a_zero  valor '0'
 dez     valor 10
+
+; coloca o caractere em A em ei_buf, na posição ei_p, e avança ei_p
+; não altera o valor de X
+poech   espaco 1
+        trax
+        armm pc_X
+        cargm ei_p
+        trax
+        armx 0
+        incx
+        cpxa
+        armm ei_p
+        cargm pc_X
+        trax
+        ret poech
+pc_X    espaco 1
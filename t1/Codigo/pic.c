@@ -0,0 +1,150 @@
+// pic.c
+// controlador de interrupções
+// simulador de computador
+// so24b
+
+#include "pic.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+pic_t *pic_cria(void)
+{
+  pic_t *self = malloc(sizeof(*self));
+  assert(self != NULL);
+
+  self->pendentes = 0;
+  self->mascara = 0;
+  self->ativas = 0;
+  self->borda = 0;
+  for (int irq = 0; irq < N_IRQ; irq++) {
+    self->prioridade[irq] = N_IRQ - irq;
+    self->pedidos[irq] = 0;
+    self->entregas[irq] = 0;
+  }
+
+  return self;
+}
+
+void pic_destroi(pic_t *self)
+{
+  free(self);
+}
+
+static void atualiza_ativas(pic_t *self)
+{
+  self->ativas = self->pendentes & ~self->mascara;
+}
+
+static bool irq_valida(irq_t irq)
+{
+  return irq >= 0 && irq < N_IRQ;
+}
+
+// CONFIGURAÇÃO
+
+void pic_define_modo(pic_t *self, irq_t irq, pic_modo_t modo)
+{
+  if (!irq_valida(irq)) return;
+  if (modo == PIC_BORDA) {
+    self->borda |= 1u << irq;
+  } else {
+    self->borda &= ~(1u << irq);
+  }
+}
+
+void pic_define_prioridade(pic_t *self, irq_t irq, int prioridade)
+{
+  if (!irq_valida(irq)) return;
+  self->prioridade[irq] = prioridade;
+}
+
+void pic_define_mascara(pic_t *self, unsigned mascara)
+{
+  self->mascara = mascara;
+  atualiza_ativas(self);
+}
+
+// PEDIDOS E ENTREGAS
+
+void pic_pede(pic_t *self, irq_t irq)
+{
+  if (!irq_valida(irq)) return;
+  self->pendentes |= 1u << irq;
+  self->pedidos[irq]++;
+  atualiza_ativas(self);
+}
+
+void pic_cancela(pic_t *self, irq_t irq)
+{
+  if (!irq_valida(irq)) return;
+  self->pendentes &= ~(1u << irq);
+  atualiza_ativas(self);
+}
+
+int pic_proxima(pic_t *self)
+{
+  int escolhida = -1;
+  for (unsigned bits = self->ativas; bits != 0; bits &= bits - 1) {
+    int irq = __builtin_ctz(bits);
+    if (escolhida == -1 || self->prioridade[irq] > self->prioridade[escolhida]) {
+      escolhida = irq;
+    }
+  }
+  return escolhida;
+}
+
+void pic_reconhece(pic_t *self, irq_t irq)
+{
+  if (!irq_valida(irq)) return;
+  self->entregas[irq]++;
+  if (self->borda & (1u << irq)) {
+    self->pendentes &= ~(1u << irq);
+    atualiza_ativas(self);
+  }
+}
+
+void pic_concatena_estatisticas(pic_t *self, char *str, int tam)
+{
+  int n = strlen(str);
+  snprintf(str + n, tam - n, "interrupções (pedidas/entregues):");
+  for (int irq = 0; irq < N_IRQ; irq++) {
+    if (self->pedidos[irq] == 0 && self->entregas[irq] == 0) continue;
+    n = strlen(str);
+    snprintf(str + n, tam - n, " %s %ld/%ld", irq_nome(irq),
+             self->pedidos[irq], self->entregas[irq]);
+  }
+}
+
+// DISPOSITIVO DE E/S
+
+err_t pic_leitura(void *disp, int id, int *pvalor)
+{
+  pic_t *self = disp;
+  switch (id) {
+    case 0:
+      *pvalor = self->pendentes;
+      break;
+    case 1:
+      *pvalor = self->mascara;
+      break;
+    default:
+      return ERR_END_INV;
+  }
+  return ERR_OK;
+}
+
+err_t pic_escrita(void *disp, int id, int valor)
+{
+  pic_t *self = disp;
+  switch (id) {
+    case 1:
+      pic_define_mascara(self, valor);
+      break;
+    default:
+      return ERR_END_INV;
+  }
+  return ERR_OK;
+}
@@ -0,0 +1,85 @@
+// pic.h
+// controlador de interrupções
+// simulador de computador
+// so24b
+
+#ifndef PIC_H
+#define PIC_H
+
+// O controlador de interrupções fica entre os dispositivos e a CPU.
+// Os dispositivos pedem interrupções ao controlador, que as mantém pendentes
+//   em uma palavra de bits (um bit por irq); o laço do controle da CPU só
+//   consulta essa palavra, e quando tem alguma interrupção pendente pede ao
+//   controlador a de maior prioridade, para entregar à CPU.
+// Cada linha de interrupção pode ser
+//   - por nível: o pedido continua pendente até o dispositivo cancelá-lo
+//     (o relógio, que mantém o pedido até o SO desligar o sinalizador)
+//   - por borda: o pedido é retirado quando a CPU aceita a interrupção
+//     (os terminais, que pedem quando o estado de algum deles muda)
+// Uma interrupção mascarada continua pendente, mas não é entregue até ser
+//   desmascarada.
+// O controlador também é um dispositivo de E/S, para o SO poder consultar as
+//   pendências e alterar a máscara.
+
+#include "err.h"
+#include "irq.h"
+
+#include <stdbool.h>
+
+typedef enum { PIC_NIVEL, PIC_BORDA } pic_modo_t;
+
+// a estrutura é visível só para pic_tem_pendente poder ser inline; não
+//   acesse os campos diretamente
+typedef struct {
+  unsigned pendentes;    // bit 'irq' ligado se a irq foi pedida
+  unsigned mascara;      // bit 'irq' ligado se a irq está mascarada
+  unsigned ativas;       // pendentes e não mascaradas
+  unsigned borda;        // bit 'irq' ligado se a linha é por borda
+  int prioridade[N_IRQ]; // maior valor, maior prioridade
+  long pedidos[N_IRQ];   // contadores
+  long entregas[N_IRQ];
+} pic_t;
+
+// cria um controlador, sem pendências e sem máscara, com todas as linhas por
+//   nível e com prioridade maior para as irqs de menor número
+pic_t *pic_cria(void);
+
+// destrói o controlador
+void pic_destroi(pic_t *self);
+
+// configura uma linha de interrupção
+void pic_define_modo(pic_t *self, irq_t irq, pic_modo_t modo);
+void pic_define_prioridade(pic_t *self, irq_t irq, int prioridade);
+
+// altera a máscara (bit 'irq' ligado para mascarar a irq)
+void pic_define_mascara(pic_t *self, unsigned mascara);
+
+// para os dispositivos: pede ou cancela o pedido de uma interrupção
+void pic_pede(pic_t *self, irq_t irq);
+void pic_cancela(pic_t *self, irq_t irq);
+
+// retorna true se tem alguma interrupção a entregar
+static inline bool pic_tem_pendente(pic_t *self)
+{
+  return self->ativas != 0;
+}
+
+// retorna a interrupção de maior prioridade a entregar, ou -1
+int pic_proxima(pic_t *self);
+
+// informa que a CPU aceitou a interrupção 'irq' (o pedido é retirado se
+//   a linha é por borda)
+void pic_reconhece(pic_t *self, irq_t irq);
+
+// concatena em str os contadores de pedidos e entregas, sem que str passe
+//   de 'tam' caracteres (contando o '\0')
+void pic_concatena_estatisticas(pic_t *self, char *str, int tam);
+
+// Funções para acessar o controlador como dispositivo de E/S, com id:
+//   '0' para ler as interrupções pendentes (um bit por irq)
+//   '1' para ler ou escrever a máscara
+// Devem seguir o protocolo f_leitura_t e f_escrita_t declarados em es.h
+err_t pic_leitura(void *disp, int id, int *pvalor);
+err_t pic_escrita(void *disp, int id, int valor);
+
+#endif // PIC_H
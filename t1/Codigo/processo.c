@@ -52,7 +52,7 @@ int proc_get_dispositivo_saida_ok(const processo_t *proc) {
 
 // dispositivo_entrada
 void proc_set_dispositivo_entrada(processo_t *proc, int dispositivo_entrada) {
-    proc->dispositivo_entrada = dispositivo_entrada - 2;
+    proc->dispositivo_entrada = dispositivo_entrada;
 }
 
 int proc_get_dispositivo_entrada(const processo_t *proc) {
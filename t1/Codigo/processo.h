@@ -1,6 +1,8 @@
 #ifndef PROCESSO_H
 #define PROCESSO_H
 
+#include "escalonador.h"
+
 typedef enum {
     KERNEL = 0,
     USUARIO = 1,
@@ -33,10 +35,14 @@ typedef struct proc_metricas_t {
 
     int preempcoes;
 
+    // tempo executando ou pronto em cada nível do escalonador MLFQ
+    int tempo_nivel[N_NIVEIS_MLFQ];
+
     double tempo_medio_de_resposta;
 } proc_metricas_t;
 
-typedef struct {
+typedef struct processo_t processo_t;
+struct processo_t {
     int pid;
     int pc;
     int a;
@@ -49,7 +55,38 @@ typedef struct {
     motivo_bloqueio_t motivo_bloqueio;
     estado_processo_t estado;
     modo_processo_t modo;
-} processo_t;
+    // para as filas de espera do SO
+    processo_t *proximo_espera;
+    // escrita em bloco em andamento: o que falta escrever (endereço e
+    //   número de caracteres) e o total
+    int escrita_end;
+    int escrita_falta;
+    int escrita_total;
+    // leitura em bloco em andamento: onde colocar e quantos no máximo
+    int leitura_end;
+    int leitura_max;
+    int instante_desbloqueio; // -1 se não foi desbloqueado desde a última execução
+    // para a tabela de processos (ver tabela_proc.h): a lista dos vivos (ou
+    //   dos livres, só com o próximo) e a lista da entrada na tabela hash
+    processo_t *proximo_tabela;
+    processo_t *anterior_tabela;
+    processo_t *proximo_hash;
+    // para a fila de prontos (ver fila.h): a fila onde está (NULL se em
+    //   nenhuma) e os vizinhos nela
+    struct fila_t *fila;
+    processo_t *proximo_fila;
+    processo_t *anterior_fila;
+    // para a fila de prontos com prioridade (ver fila_prio.h)
+    struct fila_prio_t *fila_prio;
+    int indice_prio;
+    double chave_prio;
+    unsigned long ordem_prio;
+    // nível no escalonador MLFQ (0 é o de maior prioridade)
+    int nivel_mlfq;
+    // tempo virtual de execução, para o escalonador CFS (em unidades de
+    //   tempo do relógio)
+    long vruntime;
+};
 
 // Declarações dos setters e getters
 
@@ -7,28 +7,58 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// os valores do arquivo binário são usados diretamente como int
+_Static_assert(sizeof(int) == sizeof(int32_t), "int deve ter 32 bits");
 
 struct programa_t {
   int carga;
   int tamanho;
-  int *dados;
+  int inicio;
+  const int *dados;
+  int n_reloc;
+  const int *reloc;
+  int n_simbolos;
+  const prog_simbolo_t *simbolos;
+  // para programas em formato texto, os dados foram alocados; para os em
+  //   formato binário, o arquivo está mapeado na memória
+  int *dados_alocados;
+  void *mapa;
+  size_t tam_mapa;
 };
 
+static programa_t *prog_aloca(void)
+{
+  programa_t *prog = malloc(sizeof(*prog));
+  if (prog == NULL) return NULL;
+  memset(prog, 0, sizeof(*prog));
+  return prog;
+}
+
+// FORMATO TEXTO {{{1
+
 // lê os dados do cabeçalho do arquivo (1ª linha)
 // tem "MAQ" seguido do tamanho e endereço inicial do programa
 static programa_t *pega_cabecalho(char *lin)
 {
   int tam, carga;
   if (sscanf(lin, "MAQ %d %d", &tam, &carga) != 2) return NULL;
-  programa_t *prog = malloc(sizeof(*prog));
+  programa_t *prog = prog_aloca();
   if (prog == NULL) return NULL;
-  prog->dados = calloc(sizeof(int), tam);
-  if (prog->dados == NULL) {
+  prog->dados_alocados = calloc(sizeof(int), tam);
+  if (prog->dados_alocados == NULL) {
     free(prog);
     return NULL;
   }
+  prog->dados = prog->dados_alocados;
   prog->tamanho = tam;
   prog->carga = carga;
+  prog->inicio = carga;
   return prog;
 }
 
@@ -44,16 +74,14 @@ static void pega_dados(programa_t *self, char *lin)
   int dado;
   while (sscanf(lin+pos, "%d ,%n", &dado, &p) == 1) {
     if (ender < 0 || ender >= self->tamanho) break;
-    self->dados[ender] = dado;
+    self->dados_alocados[ender] = dado;
     ender++;
     pos += p;
   }
 }
 
-programa_t *prog_cria(char *nome)
+static programa_t *prog_cria_texto(FILE *arq)
 {
-  FILE *arq = fopen(nome, "r");
-  if (arq == NULL) return NULL;
   char *linha = NULL;
   size_t tam_lin;
   programa_t *prog = NULL;
@@ -65,16 +93,72 @@ programa_t *prog_cria(char *nome)
   }
 fim:
   free(linha);
+  return prog;
+}
+
+// FORMATO BINÁRIO {{{1
+
+// mapeia o arquivo aberto em 'fd' na memória, e aponta os dados do programa
+//   para as seções do arquivo
+static programa_t *prog_cria_binario(int fd)
+{
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < sizeof(prog_cabecalho_t)) return NULL;
+  void *mapa = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (mapa == MAP_FAILED) return NULL;
+
+  const prog_cabecalho_t *cab = mapa;
+  // confere se as seções cabem no arquivo
+  size_t tam_esperado = sizeof(*cab)
+                      + (size_t)cab->tamanho * sizeof(int32_t)
+                      + (size_t)cab->n_reloc * sizeof(int32_t)
+                      + (size_t)cab->n_simbolos * sizeof(prog_simbolo_t);
+  programa_t *prog = NULL;
+  if (cab->tamanho < 0 || cab->n_reloc < 0 || cab->n_simbolos < 0
+      || tam_esperado > st.st_size || (prog = prog_aloca()) == NULL) {
+    munmap(mapa, st.st_size);
+    return NULL;
+  }
+  prog->mapa = mapa;
+  prog->tam_mapa = st.st_size;
+  prog->carga = cab->carga;
+  prog->tamanho = cab->tamanho;
+  prog->inicio = cab->inicio;
+  prog->dados = (const int *)(cab + 1);
+  prog->n_reloc = cab->n_reloc;
+  prog->reloc = prog->dados + prog->tamanho;
+  prog->n_simbolos = cab->n_simbolos;
+  prog->simbolos = (const prog_simbolo_t *)(prog->reloc + prog->n_reloc);
+  return prog;
+}
+
+// CRIAÇÃO {{{1
+
+programa_t *prog_cria(char *nome)
+{
+  FILE *arq = fopen(nome, "r");
+  if (arq == NULL) return NULL;
+  programa_t *prog;
+  int32_t magico;
+  if (fread(&magico, sizeof(magico), 1, arq) == 1 && magico == PROG_MAGICO) {
+    prog = prog_cria_binario(fileno(arq));
+  } else {
+    rewind(arq);
+    prog = prog_cria_texto(arq);
+  }
   fclose(arq);
   return prog;
 }
 
 void prog_destroi(programa_t *self)
 {
-  free(self->dados);
+  if (self->mapa != NULL) munmap(self->mapa, self->tam_mapa);
+  free(self->dados_alocados);
   free(self);
 }
 
+// ACESSO {{{1
+
 int prog_tamanho(programa_t *self)
 {
   return self->tamanho;
@@ -87,7 +171,7 @@ int prog_end_carga(programa_t *self)
 
 int prog_end_inicio(programa_t *self)
 {
-  return self->carga;
+  return self->inicio;
 }
 
 int prog_dado(programa_t *self, int ender)
@@ -95,3 +179,37 @@ int prog_dado(programa_t *self, int ender)
   if (ender < self->carga || ender >= self->carga + self->tamanho) return -1;
   return self->dados[ender - self->carga];
 }
+
+const int *prog_dados(programa_t *self)
+{
+  return self->dados;
+}
+
+int prog_n_reloc(programa_t *self)
+{
+  return self->n_reloc;
+}
+
+int prog_reloc(programa_t *self, int i)
+{
+  if (i < 0 || i >= self->n_reloc) return -1;
+  return self->reloc[i];
+}
+
+int prog_simbolo(programa_t *self, char *nome)
+{
+  for (int i = 0; i < self->n_simbolos; i++) {
+    if (strncmp(self->simbolos[i].nome, nome, PROG_TAM_NOME) == 0) {
+      return self->simbolos[i].valor;
+    }
+  }
+  return -1;
+}
+
+size_t prog_memoria(programa_t *self)
+{
+  if (self->mapa != NULL) return sizeof(*self) + self->tam_mapa;
+  return sizeof(*self) + (size_t)self->tamanho * sizeof(int);
+}
+
+// vim: foldmethod=marker
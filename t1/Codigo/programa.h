@@ -6,11 +6,40 @@
 #ifndef PROGRAMA_H
 #define PROGRAMA_H
 
+#include <stdint.h>
+#include <stddef.h>
+
 // TAD para representar um programa lido de um arquivo '.maq'
+// o arquivo pode estar em formato texto (gerado pelo montador) ou binário
+//   (gerado por "montador -b"); o formato é reconhecido pelo conteúdo
 
 typedef struct programa_t programa_t;
 
+// formato binário: o cabeçalho abaixo, seguido de
+//   - 'tamanho' valores int32_t, com o conteúdo da memória a partir de 'carga'
+//   - 'n_reloc' valores int32_t, com os endereços que contêm endereços do
+//     programa (que devem ser ajustados se o programa for carregado em outro
+//     endereço)
+//   - 'n_simbolos' prog_simbolo_t, com os labels do programa
+// todos os valores estão na ordem de bytes da máquina que montou
+#define PROG_MAGICO 0x4251414d   // "MAQB"
+typedef struct {
+  int32_t magico;
+  int32_t carga;       // endereço de carga
+  int32_t tamanho;     // número de valores na memória
+  int32_t inicio;      // endereço inicial de execução
+  int32_t n_reloc;
+  int32_t n_simbolos;
+} prog_cabecalho_t;
+
+#define PROG_TAM_NOME 28
+typedef struct {
+  char nome[PROG_TAM_NOME];   // terminado por '\0'
+  int32_t valor;
+} prog_simbolo_t;
+
 // cria e inicializa um programa com o conteúdo do arquivo 'nome'
+// um arquivo binário é mapeado na memória (mmap), e não copiado
 // retorna NULL em caso de erro
 programa_t *prog_cria(char *nome);
 
@@ -31,4 +60,22 @@ int prog_end_inicio(programa_t *self);
 // valor a colocar na posição 'ender' da memória
 int prog_dado(programa_t *self, int ender);
 
+// os valores a colocar na memória, a partir do endereço de carga
+// (prog_tamanho valores; não podem ser alterados)
+const int *prog_dados(programa_t *self);
+
+// número de endereços a relocar (0 para programas em formato texto)
+int prog_n_reloc(programa_t *self);
+
+// o 'i'-ésimo endereço a relocar: a posição de memória com esse endereço
+//   contém um endereço do programa
+int prog_reloc(programa_t *self, int i);
+
+// valor do símbolo 'nome', ou -1 se não existir (ou se o programa não tem
+//   símbolos, como os em formato texto)
+int prog_simbolo(programa_t *self, char *nome);
+
+// quantidade de memória (em bytes) ocupada pelo programa no simulador
+size_t prog_memoria(programa_t *self);
+
 #endif // PROGRAMA_H
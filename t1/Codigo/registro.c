@@ -0,0 +1,177 @@
+// registro.c
+// registro (log) de linhas de texto em arquivo, gravado por outra thread
+// simulador de computador
+// so24b
+
+#include "registro.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <assert.h>
+
+// tempo que a thread gravadora dorme quando não tem nada na fila
+#define NS_ESPERA_GRAVADORA 1000000
+
+// tamanho do buffer onde a gravadora junta as linhas antes de gravar
+#define TAM_LOTE (64 * 1024)
+
+typedef struct {
+  // a posição está livre para o produtor que pegar o índice 'i' quando
+  //   seq == i, e preenchida para o consumidor quando seq == i + 1
+  _Atomic unsigned seq;
+  char txt[REGISTRO_TAM_LINHA];
+} posicao_t;
+
+struct registro_t {
+  FILE *arquivo;
+  unsigned mascara;            // capacidade - 1
+  posicao_t *fila;
+  _Atomic unsigned fim;        // próximo índice a ser pego por um produtor
+  unsigned inicio;             // próximo índice a retirar (só a gravadora)
+  _Atomic long descartadas;
+  _Atomic bool terminar;
+  pthread_t gravadora;
+};
+
+static void *registro_gravadora(void *arg);
+
+registro_t *registro_cria(char *nome, int n_linhas)
+{
+  FILE *arquivo = fopen(nome, "w");
+  if (arquivo == NULL) return NULL;
+
+  registro_t *self = malloc(sizeof(*self));
+  assert(self != NULL);
+
+  unsigned cap = 1;
+  while (cap < n_linhas) cap *= 2;
+  self->arquivo = arquivo;
+  self->mascara = cap - 1;
+  self->fila = malloc(cap * sizeof(*self->fila));
+  assert(self->fila != NULL);
+  for (unsigned i = 0; i < cap; i++) {
+    atomic_init(&self->fila[i].seq, i);
+  }
+  atomic_init(&self->fim, 0);
+  self->inicio = 0;
+  atomic_init(&self->descartadas, 0);
+  atomic_init(&self->terminar, false);
+
+  int r = pthread_create(&self->gravadora, NULL, registro_gravadora, self);
+  assert(r == 0);
+
+  return self;
+}
+
+void registro_destroi(registro_t *self)
+{
+  atomic_store(&self->terminar, true);
+  pthread_join(self->gravadora, NULL);
+  fclose(self->arquivo);
+  free(self->fila);
+  free(self);
+}
+
+long registro_descartadas(registro_t *self)
+{
+  return atomic_load_explicit(&self->descartadas, memory_order_relaxed);
+}
+
+// PRODUTORES
+
+bool registro_escreve(registro_t *self, const char *linha)
+{
+  unsigned pos = atomic_load_explicit(&self->fim, memory_order_relaxed);
+  posicao_t *p;
+  for (;;) {
+    p = &self->fila[pos & self->mascara];
+    unsigned seq = atomic_load_explicit(&p->seq, memory_order_acquire);
+    int dif = (int)(seq - pos);
+    if (dif == 0) {
+      // a posição está livre; tenta ficar com ela
+      if (atomic_compare_exchange_weak_explicit(&self->fim, &pos, pos + 1,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed)) {
+        break;
+      }
+      // outro produtor pegou; 'pos' foi atualizado pelo CAS
+    } else if (dif < 0) {
+      // a posição ainda não foi liberada pela gravadora: a fila está cheia
+      atomic_fetch_add_explicit(&self->descartadas, 1, memory_order_relaxed);
+      return false;
+    } else {
+      // outro produtor já avançou; tenta de novo com o fim atual
+      pos = atomic_load_explicit(&self->fim, memory_order_relaxed);
+    }
+  }
+  size_t tam = strnlen(linha, REGISTRO_TAM_LINHA - 1);
+  memcpy(p->txt, linha, tam);
+  p->txt[tam] = '\0';
+  // publica a linha para a gravadora
+  atomic_store_explicit(&p->seq, pos + 1, memory_order_release);
+  return true;
+}
+
+// GRAVADORA
+
+// retira da fila as linhas prontas, juntando-as em 'lote' e gravando quando
+//   ele enche; retorna o número de linhas retiradas
+static int registro_drena(registro_t *self, char *lote, int *ptam)
+{
+  int n = 0;
+  for (;;) {
+    posicao_t *p = &self->fila[self->inicio & self->mascara];
+    unsigned seq = atomic_load_explicit(&p->seq, memory_order_acquire);
+    if (seq != self->inicio + 1) break;  // vazia, ou ainda sendo preenchida
+    int tam = strlen(p->txt);
+    if (*ptam + tam + 1 > TAM_LOTE) {
+      fwrite(lote, 1, *ptam, self->arquivo);
+      *ptam = 0;
+    }
+    memcpy(lote + *ptam, p->txt, tam);
+    lote[*ptam + tam] = '\n';
+    *ptam += tam + 1;
+    // libera a posição para o produtor da próxima volta
+    atomic_store_explicit(&p->seq, self->inicio + self->mascara + 1,
+                          memory_order_release);
+    self->inicio++;
+    n++;
+  }
+  return n;
+}
+
+static void *registro_gravadora(void *arg)
+{
+  registro_t *self = arg;
+  char *lote = malloc(TAM_LOTE);
+  assert(lote != NULL);
+  long descartes_informados = 0;
+  struct timespec espera = { 0, NS_ESPERA_GRAVADORA };
+
+  for (;;) {
+    // lido antes de drenar: se já era para terminar, nenhuma linha nova vai
+    //   chegar depois da drenagem
+    bool terminar = atomic_load(&self->terminar);
+    int tam = 0;
+    int n = registro_drena(self, lote, &tam);
+    if (tam > 0) fwrite(lote, 1, tam, self->arquivo);
+    long descartadas = registro_descartadas(self);
+    if (descartadas != descartes_informados) {
+      fprintf(self->arquivo, "[registro: %ld linhas descartadas]\n",
+              descartadas - descartes_informados);
+      descartes_informados = descartadas;
+    }
+    if (n == 0) {
+      if (terminar) break;
+      fflush(self->arquivo);
+      nanosleep(&espera, NULL);
+    }
+  }
+
+  free(lote);
+  return NULL;
+}
@@ -0,0 +1,43 @@
+// registro.h
+// registro (log) de linhas de texto em arquivo, gravado por outra thread
+// simulador de computador
+// so24b
+
+#ifndef REGISTRO_H
+#define REGISTRO_H
+
+// Quem registra uma linha só a copia para uma fila circular de capacidade
+//   fixa; uma thread separada retira as linhas da fila e as grava no arquivo
+//   em lotes. Várias threads podem registrar linhas ao mesmo tempo (a fila
+//   não usa travas: cada posição tem um número de sequência que diz se ela
+//   está livre ou preenchida, e os produtores disputam as posições com
+//   compare-and-swap).
+// A memória usada é limitada: se a fila estiver cheia, a linha é descartada
+//   e contada; a thread gravadora insere no arquivo uma linha avisando
+//   quantas foram descartadas, no ponto em que foram perdidas.
+// Linhas maiores que REGISTRO_TAM_LINHA-1 caracteres são truncadas.
+
+#include <stdbool.h>
+
+#define REGISTRO_TAM_LINHA 256
+
+typedef struct registro_t registro_t;
+
+// cria um registro que grava no arquivo 'nome' (que é truncado), com
+//   capacidade para pelo menos 'n_linhas' linhas na fila, e dispara a thread
+//   gravadora
+// retorna NULL se não conseguir criar o arquivo
+registro_t *registro_cria(char *nome, int n_linhas);
+
+// grava as linhas que ainda estão na fila, termina a thread, fecha o arquivo
+//   e libera a memória
+void registro_destroi(registro_t *self);
+
+// coloca uma linha na fila para ser gravada (é acrescentado um '\n')
+// retorna false se a linha foi descartada por falta de espaço
+bool registro_escreve(registro_t *self, const char *linha);
+
+// número de linhas descartadas até agora
+long registro_descartadas(registro_t *self);
+
+#endif // REGISTRO_H
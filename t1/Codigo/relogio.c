@@ -16,6 +16,8 @@ struct relogio_t {
   int t_ate_interrupcao;
   // 1 se está gerando interrupção, 0 se não
   int interrupcao;
+  // controlador onde a interrupção é pedida (ou NULL)
+  pic_t *pic;
 };
 
 relogio_t *relogio_cria(void)
@@ -25,6 +27,9 @@ relogio_t *relogio_cria(void)
   assert(self != NULL);
 
   self->agora = 0;
+  self->t_ate_interrupcao = 0;
+  self->interrupcao = 0;
+  self->pic = NULL;
 
   return self;
 }
@@ -34,6 +39,25 @@ void relogio_destroi(relogio_t *self)
   free(self);
 }
 
+void relogio_conecta_pic(relogio_t *self, pic_t *pic)
+{
+  self->pic = pic;
+}
+
+// altera o sinalizador de interrupção, e a linha de interrupção no
+//   controlador, que fica ligada enquanto o sinalizador estiver
+static void relogio_muda_interrupcao(relogio_t *self, int interrupcao)
+{
+  if (interrupcao == self->interrupcao) return;
+  self->interrupcao = interrupcao;
+  if (self->pic == NULL) return;
+  if (interrupcao) {
+    pic_pede(self->pic, IRQ_RELOGIO);
+  } else {
+    pic_cancela(self->pic, IRQ_RELOGIO);
+  }
+}
+
 void relogio_tictac(relogio_t *self)
 {
   self->agora++;
@@ -41,11 +65,23 @@ void relogio_tictac(relogio_t *self)
   if (self->t_ate_interrupcao != 0) {
     self->t_ate_interrupcao--;
     if (self->t_ate_interrupcao == 0) {
-      self->interrupcao = 1;
+      relogio_muda_interrupcao(self, 1);
     }
   }
 }
 
+void relogio_avanca(relogio_t *self, int n)
+{
+  self->agora += n;
+  // o timer para de ser decrementado quando chega a 0
+  if (self->t_ate_interrupcao > 0 && n >= self->t_ate_interrupcao) {
+    self->t_ate_interrupcao = 0;
+    relogio_muda_interrupcao(self, 1);
+  } else if (self->t_ate_interrupcao != 0) {
+    self->t_ate_interrupcao -= n;
+  }
+}
+
 int relogio_agora(relogio_t *self)
 {
   return self->agora;
@@ -83,7 +119,7 @@ err_t relogio_escrita(void *disp, int id, int pvalor)
       self->t_ate_interrupcao = pvalor;
       break;
     case 3:
-      self->interrupcao = (pvalor == 0) ? 0 : 1;
+      relogio_muda_interrupcao(self, (pvalor == 0) ? 0 : 1);
       break;
     default: 
       err = ERR_END_INV;
@@ -10,6 +10,7 @@
 // registra a passagem do tempo
 
 #include "err.h"
+#include "pic.h"
 
 typedef struct relogio_t relogio_t;
 
@@ -20,10 +21,19 @@ relogio_t *relogio_cria(void);
 // nenhuma outra operação pode ser realizada no relógio após esta chamada
 void relogio_destroi(relogio_t *self);
 
+// liga a saída de interrupção do relógio ao controlador de interrupções
+// a interrupção IRQ_RELOGIO fica pedida enquanto o sinalizador de
+//   interrupção (dispositivo '3') estiver ligado
+void relogio_conecta_pic(relogio_t *self, pic_t *pic);
+
 // registra a passagem de uma unidade de tempo
 // esta função é chamada pelo controlador após a execução de cada instrução
 void relogio_tictac(relogio_t *self);
 
+// registra a passagem de 'n' unidades de tempo de uma vez
+// tem o mesmo efeito que 'n' chamadas a relogio_tictac
+void relogio_avanca(relogio_t *self, int n);
+
 // retorna a hora atual do sistema, em unidades de tempo
 int relogio_agora(relogio_t *self);
 
@@ -10,48 +10,79 @@
 #include "programa.h"
 #include "instrucao.h"
 #include "processo.h"
+#include "cache_prog.h"
+#include "tabela_proc.h"
+#include "fila.h"
+#include "fila_prio.h"
+#include "traco.h"
 
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <assert.h>
 
 #define INTERVALO_INTERRUPCAO 50
 #define INTERVALO_QUANTUM     10
-#define MAX_PROCESSOS         10
-#define PID_NENHUM            -1
+#define ORCAMENTO_CACHE_PROG  (64 * 1024)  // bytes
+#define PROGRAMA_INICIAL      "init.maq"
 
-typedef enum {
-  ESCALONADOR_NORMAL,
-  ESCALONADOR_ROUND_ROBIN,
-  ESCALONADOR_ROUND_ROBIN_PRIORIDADE
-} escalonador_t;
+// escalonador MLFQ: o quantum de cada nível (em interrupções de relógio), e
+//   o intervalo entre as voltas de todos ao nível 0, em unidades de tempo do
+//   relógio (que passa também com a CPU parada, não só executando instruções)
+static const int quantum_mlfq[N_NIVEIS_MLFQ] = { 5, 10, 20 };
+#define PERIODO_REFORCO_MLFQ  5000
 
-typedef struct no {
-  processo_t *processo;
-  struct no *proximo;
-  struct no *anterior;
-} no_t;
+// escalonador CFS: valores padrão da latência alvo e da granularidade mínima
+//   (em unidades de tempo do relógio)
+#define LATENCIA_CFS          1000
+#define GRANULARIDADE_CFS     100
 
+// fila de processos bloqueados, ligados pelo campo proximo_espera
 typedef struct {
-  no_t *inicio;
-  no_t *fim;
-} fila_t;
+  processo_t *inicio;
+  processo_t *fim;
+} fila_espera_t;
 
 struct so_t {
   cpu_t *cpu;
   mem_t *mem;
   es_t *es;
   console_t *console;
-  processo_t tabela_processos[MAX_PROCESSOS];
+  tabela_proc_t *tabela;
   processo_t *processo_corrente;
   fila_t *fila_processos;
+  // a fila de prontos do escalonador com prioridade
+  fila_prio_t *prontos_prio;
+  // as filas de prontos de cada nível do escalonador MLFQ, e quando todos
+  //   voltam ao nível 0
+  fila_t *niveis_mlfq[N_NIVEIS_MLFQ];
+  int proximo_reforco;
+  int reforcos;
+  // o escalonador CFS usa a fila com prioridade (prontos_prio), com o
+  //   vruntime como chave
+  int latencia_cfs;
+  int granularidade_cfs;
+  long vruntime_min;       // o menor vruntime dos prontos; nunca diminui
+  int inicio_fatia;        // quando o processo corrente foi escolhido
+  cache_prog_t *cache_prog;
+  char *programa_inicial;
+  // processos esperando cada dispositivo (só os de terminal são usados)
+  fila_espera_t espera_dispositivo[N_DISPOSITIVOS];
+  // processos esperando o término de outro
+  fila_espera_t espera_processo;
+  // o último processo despachado, para contar as trocas de contexto
+  processo_t *ultimo_despachado;
 
   escalonador_t escalonador;
 
+  // cópias dos descritores dos processos que terminaram, para as métricas
+  processo_t *finalizados;
+  int n_finalizados;
+  int tam_finalizados;
+
   int quantidade_processos;
   int quantum;
   int relogio;
-  int contador_pid;
   bool erro_interno;
 
   int ultimo_relogio;
@@ -59,6 +90,10 @@ struct so_t {
   int tempo_ocioso;
   int preempcoes_totais;
   int *interrupcoes;
+  int trocas_de_contexto;
+  int desbloqueios;
+  int latencia_desbloqueio;     // soma, do desbloqueio até executar
+  int verificacoes_dispositivo; // consultas ao estado de dispositivos
 };
 
 void atualiza_metricas(so_t *self, int irq)
@@ -68,29 +103,30 @@ void atualiza_metricas(so_t *self, int irq)
   int ultimo_relogio = self->ultimo_relogio;
   if(es_le(self->es, D_RELOGIO_INSTRUCOES, &self->ultimo_relogio) != ERR_OK)
   {
-    console_printf("Erro na leitura do relógio");
+    traco_erro(TRACO_GERAL, "Erro na leitura do relógio");
     exit(-1);
   }
 
   int elapsed_time = self->ultimo_relogio - ultimo_relogio;
 
-  for (int i = 0; i < self->quantidade_processos; i++)
+  for (processo_t *proc = tabela_proc_primeiro(self->tabela); proc != NULL;
+       proc = tabela_proc_proximo(proc))
   {
-    processo_t *proc = &self->tabela_processos[i];
-    if(proc != NULL) {
-      switch (proc_get_estado(proc)) {
-        case EXECUTANDO:
-          proc->metricas.tempo_executando += elapsed_time;
-          break;
-        case PRONTO:
-          proc->metricas.tempo_pronto += elapsed_time;
-          break;
-        case BLOQUEADO:
-          proc->metricas.tempo_bloqueado += elapsed_time;
-          break;
-        default:
-          break;
-      }
+    switch (proc_get_estado(proc)) {
+      case EXECUTANDO:
+        proc->metricas.tempo_executando += elapsed_time;
+        proc->metricas.tempo_nivel[proc->nivel_mlfq] += elapsed_time;
+        proc->vruntime += elapsed_time;
+        break;
+      case PRONTO:
+        proc->metricas.tempo_pronto += elapsed_time;
+        proc->metricas.tempo_nivel[proc->nivel_mlfq] += elapsed_time;
+        break;
+      case BLOQUEADO:
+        proc->metricas.tempo_bloqueado += elapsed_time;
+        break;
+      default:
+        break;
     }
   }
 }
@@ -106,74 +142,14 @@ static bool copia_str_da_mem(int tam, char str[tam], mem_t *mem, int ender);
 
 // CRIAÇÃO {{{1
 
-// Inicializa a tabela de processos do SO
-static void so_inicializa_tabela_processos(so_t *self) {
-	for (int i = 0; i < MAX_PROCESSOS; i++) {
-		self->tabela_processos[i].pid = PID_NENHUM;
-		self->tabela_processos[i].pc = 0;
-		self->tabela_processos[i].a = 0;
-		self->tabela_processos[i].x = 0;
-		self->tabela_processos[i].estado = PARADO;
-		self->tabela_processos[i].modo = KERNEL;
-		self->tabela_processos[i].pid_esperado = 0;
-		self->tabela_processos[i].motivo_bloqueio = 0;
-		self->tabela_processos[i].prioridade = 0;
-
-		// Inicializa métricas
-		self->tabela_processos[i].metricas.vezes_pronto = 0;
-		self->tabela_processos[i].metricas.vezes_executando = 0;
-		self->tabela_processos[i].metricas.vezes_bloqueado = 0;
-		self->tabela_processos[i].metricas.tempo_pronto = 0;
-		self->tabela_processos[i].metricas.tempo_executando = 0;
-		self->tabela_processos[i].metricas.tempo_bloqueado = 0;
-		self->tabela_processos[i].metricas.tempo_total = 0;
-		self->tabela_processos[i].metricas.tempo_medio_de_resposta = 0;
-		self->tabela_processos[i].metricas.preempcoes = 0;
-	}
-}
-
-
 // Configura o timer do SO
 static void so_configura_timer(so_t *self) {
   if (es_escreve(self->es, D_RELOGIO_TIMER, INTERVALO_INTERRUPCAO) != ERR_OK) {
-    console_printf("SO: problema na programação do timer\n");
+    traco_erro(TRACO_IRQ, "SO: problema na programação do timer\n");
     self->erro_interno = true;
   }
 }
 
-fila_t *cira_fila() {  // Alteração: retorno de ponteiro
-  fila_t *self = (fila_t *)malloc(sizeof(fila_t));
-  
-  self->inicio = NULL;
-  self->fim = NULL;
-  
-  return self;  // Aqui o retorno já está correto como ponteiro
-}
-
-void remove_fila (fila_t *self, processo_t *proc) {
-  for (no_t *no = self->inicio; no != NULL; no = no->proximo) {
-    if (no->processo != proc) {
-      continue;
-    }
-
-    if (no->anterior != NULL) {
-      no->anterior->proximo = no->proximo;
-    } else {
-      self->inicio = no->proximo;
-    }
-
-    if (no->proximo != NULL) {
-      no->proximo->anterior = no->anterior;
-    } else {
-      self->fim = no->anterior;
-    }
-
-    free(no);
-
-    break;
-  }
-}
-
 so_t *so_cria(cpu_t *cpu, mem_t *mem, es_t *es, console_t *console) {
   so_t *self = malloc(sizeof(*self));
   if (self == NULL) return NULL;
@@ -185,7 +161,6 @@ so_t *so_cria(cpu_t *cpu, mem_t *mem, es_t *es, console_t *console) {
   self->console = console;
   self->erro_interno = false;
   self->quantidade_processos = 0;
-  self->contador_pid = 0;      // Inicializa o contador de PIDs
   self->processo_corrente = NULL; // Nenhum processo em execução inicialmente
   self->relogio = -1;
   self->quantum = 0;
@@ -197,15 +172,38 @@ so_t *so_cria(cpu_t *cpu, mem_t *mem, es_t *es, console_t *console) {
   self->escalonador = 0;
   self->interrupcoes = (int *)malloc(6 * sizeof(int));
 
-  self->fila_processos = cira_fila();
-
-  // Inicializa a tabela de processos e a fila de processos
-  so_inicializa_tabela_processos(self);
+  self->fila_processos = fila_cria();
+  self->prontos_prio = fila_prio_cria();
+  for (int n = 0; n < N_NIVEIS_MLFQ; n++) {
+    self->niveis_mlfq[n] = fila_cria();
+  }
+  self->proximo_reforco = PERIODO_REFORCO_MLFQ;
+  self->reforcos = 0;
+  self->latencia_cfs = LATENCIA_CFS;
+  self->granularidade_cfs = GRANULARIDADE_CFS;
+  self->vruntime_min = 0;
+  self->inicio_fatia = 0;
+  self->cache_prog = cache_prog_cria(ORCAMENTO_CACHE_PROG);
+  self->programa_inicial = PROGRAMA_INICIAL;
+  for (int d = 0; d < N_DISPOSITIVOS; d++) {
+    self->espera_dispositivo[d] = (fila_espera_t){ NULL, NULL };
+  }
+  self->espera_processo = (fila_espera_t){ NULL, NULL };
+  self->ultimo_despachado = NULL;
+  self->trocas_de_contexto = 0;
+  self->desbloqueios = 0;
+  self->latencia_desbloqueio = 0;
+  self->verificacoes_dispositivo = 0;
+
+  self->tabela = tabela_proc_cria();
+  self->finalizados = NULL;
+  self->n_finalizados = 0;
+  self->tam_finalizados = 0;
 
   cpu_define_chamaC(self->cpu, so_trata_interrupcao, self);
   int ender = so_carrega_programa(self, "trata_int.maq");
   if (ender != IRQ_END_TRATADOR) {
-    console_printf("SO: problema na carga do programa de tratamento de interrupção");
+    traco_erro(TRACO_CARGA, "SO: problema na carga do programa de tratamento de interrupção");
     self->erro_interno = true;
   }
 
@@ -216,21 +214,91 @@ so_t *so_cria(cpu_t *cpu, mem_t *mem, es_t *es, console_t *console) {
 void so_destroi(so_t *self)
 {
   cpu_define_chamaC(self->cpu, NULL, NULL);
+  cache_prog_destroi(self->cache_prog);
+  fila_destroi(self->fila_processos);
+  fila_prio_destroi(self->prontos_prio);
+  for (int n = 0; n < N_NIVEIS_MLFQ; n++) {
+    fila_destroi(self->niveis_mlfq[n]);
+  }
+  tabela_proc_destroi(self->tabela);
+  free(self->finalizados);
   free(self);
 }
 
+void so_define_orcamento_cache(so_t *self, size_t bytes)
+{
+  cache_prog_define_orcamento(self->cache_prog, bytes);
+}
+
+void so_define_programa_inicial(so_t *self, char *nome)
+{
+  self->programa_inicial = nome;
+}
+
+void so_define_escalonador(so_t *self, escalonador_t escalonador)
+{
+  self->escalonador = escalonador;
+}
+
+void so_define_cfs(so_t *self, int latencia, int granularidade)
+{
+  if (latencia > 0) self->latencia_cfs = latencia;
+  if (granularidade > 0) self->granularidade_cfs = granularidade;
+}
+
 static void so_salva_estado_da_cpu(so_t *self);
 static void so_trata_irq(so_t *self, int irq);
-static void so_trata_pendencias(so_t *self);
 static void so_escalona(so_t *self);
 static int so_despacha(so_t *self);
 
+static int compara_pid(const void *a, const void *b)
+{
+  return proc_get_pid(a) - proc_get_pid(b);
+}
+
+// o tempo que cada processo passou (executando ou pronto) em cada nível do
+//   escalonador MLFQ, e o total de todos
+static void so_imprime_niveis_mlfq(so_t *self, FILE *arquivo)
+{
+    fprintf(arquivo, "\n------------- NÍVEIS DO MLFQ -------------\n");
+    fprintf(arquivo, "| PID |");
+    for (int n = 0; n < N_NIVEIS_MLFQ; n++) {
+        fprintf(arquivo, " Nível %d (q=%-2d)   |", n, quantum_mlfq[n]);
+    }
+    fprintf(arquivo, "\n|-----|");
+    for (int n = 0; n < N_NIVEIS_MLFQ; n++) {
+        fprintf(arquivo, "------------------|");
+    }
+    fprintf(arquivo, "\n");
+
+    int total[N_NIVEIS_MLFQ] = { 0 };
+    int soma = 0;
+    for (int i = 0; i < self->n_finalizados; i++) {
+        processo_t *proc = &self->finalizados[i];
+        int tempo = 0;
+        for (int n = 0; n < N_NIVEIS_MLFQ; n++) tempo += proc->metricas.tempo_nivel[n];
+        fprintf(arquivo, "| %-3d |", proc_get_pid(proc));
+        for (int n = 0; n < N_NIVEIS_MLFQ; n++) {
+            int t = proc->metricas.tempo_nivel[n];
+            fprintf(arquivo, " %-7d (%5.1f%%) |", t, tempo == 0 ? 0.0 : 100.0 * t / tempo);
+            total[n] += t;
+        }
+        fprintf(arquivo, "\n");
+        soma += tempo;
+    }
+    fprintf(arquivo, "| tot |");
+    for (int n = 0; n < N_NIVEIS_MLFQ; n++) {
+        fprintf(arquivo, " %-7d (%5.1f%%) |", total[n], soma == 0 ? 0.0 : 100.0 * total[n] / soma);
+    }
+    fprintf(arquivo, "\n  Voltas de todos ao nível 0  : %d\n", self->reforcos);
+}
+
 void so_imprime_metricas(so_t *self) {
     const char *nome_arquivo = "metricas_processos.txt";
 
     FILE *arquivo = fopen(nome_arquivo, "w");
     if (arquivo == NULL) {
-        console_printf("Erro ao abrir o arquivo '%s' para escrita.\n", nome_arquivo);
+        traco_erro(TRACO_GERAL, "Erro ao abrir o arquivo '%s' para escrita.\n", nome_arquivo);
         return;
     }
 
@@ -243,6 +311,11 @@ void so_imprime_metricas(so_t *self) {
     fprintf(arquivo, "  Tempo total de execução    : %d\n", self->tempo_execucao);
     fprintf(arquivo, "  Tempo total ocioso         : %d\n", self->tempo_ocioso);
     fprintf(arquivo, "  Número de preempções       : %d\n", self->preempcoes_totais);
+    fprintf(arquivo, "  Trocas de contexto         : %d\n", self->trocas_de_contexto);
+    fprintf(arquivo, "  Desbloqueios               : %d\n", self->desbloqueios);
+    fprintf(arquivo, "  Latência média de desbloq. : %.2f\n", self->desbloqueios == 0 ? 0.0
+            : (double)self->latencia_desbloqueio / self->desbloqueios);
+    fprintf(arquivo, "  Consultas a dispositivos   : %d\n", self->verificacoes_dispositivo);
     fprintf(arquivo, "\nINTERRUPÇÕES:\n");
     fprintf(arquivo, "  IRQ_RESET                  : %d\n", self->interrupcoes[IRQ_RESET]);
     fprintf(arquivo, "  IRQ_ERR_CPU                : %d\n", self->interrupcoes[IRQ_ERR_CPU]);
@@ -251,15 +324,25 @@ void so_imprime_metricas(so_t *self) {
     fprintf(arquivo, "  IRQ_TECLADO                : %d\n", self->interrupcoes[IRQ_TECLADO]);
     fprintf(arquivo, "  IRQ_TELA                   : %d\n", self->interrupcoes[IRQ_TELA]);
 
+    char estatisticas[200] = "";
+    cache_prog_concatena_estatisticas(self->cache_prog, estatisticas,
+                                      sizeof(estatisticas));
+    fprintf(arquivo, "\nCARGA DE PROGRAMAS:\n");
+    fprintf(arquivo, "  %s\n", estatisticas);
+
     fprintf(arquivo, "\n============================ MÉTRICAS DOS PROCESSOS ============================\n\n");
 
+    // os processos são arquivados na ordem em que terminam; o relatório é
+    //   na ordem dos pids
+    qsort(self->finalizados, self->n_finalizados, sizeof(*self->finalizados), compara_pid);
+
     // Tabela de tempos
     fprintf(arquivo, "------------- TABELA DE TEMPOS -------------\n");
     fprintf(arquivo, "| PID | Tempo Exec. | Tempo Pronto | Tempo Bloq. | Tempo Retorno | Resp. Médio |\n");
     fprintf(arquivo, "|-----|-------------|--------------|-------------|---------------|-------------|\n");
 
-    for (int i = 0; i < self->quantidade_processos; i++) {
-        processo_t *proc = &self->tabela_processos[i];
+    for (int i = 0; i < self->n_finalizados; i++) {
+        processo_t *proc = &self->finalizados[i];
         fprintf(arquivo,
             "| %-3d | %-11d | %-12d | %-11d | %-13d | %-11.2f |\n",
             proc_get_pid(proc),
@@ -275,8 +358,8 @@ void so_imprime_metricas(so_t *self) {
     fprintf(arquivo, "|-----|-----------|------------|--------------|-------------|\n");
 
     // Tabela de vezes
-    for (int i = 0; i < self->quantidade_processos; i++) {
-        processo_t *proc = &self->tabela_processos[i];
+    for (int i = 0; i < self->n_finalizados; i++) {
+        processo_t *proc = &self->finalizados[i];
         fprintf(arquivo,
             "| %-3d | %-9d | %-10d | %-12d | %-11d |\n",
             proc_get_pid(proc),
@@ -286,33 +369,49 @@ void so_imprime_metricas(so_t *self) {
             proc_get_vezes_bloqueado(proc));
     }
 
+    if (self->escalonador == ESCALONADOR_MLFQ) {
+        so_imprime_niveis_mlfq(self, arquivo);
+    }
+
     fprintf(arquivo, "\n================================================================================\n");
 
     fclose(arquivo);
 
-    console_printf("Métricas salvas no arquivo '%s'.\n", nome_arquivo);
+    traco_info(TRACO_GERAL, "Métricas salvas no arquivo '%s'.\n", nome_arquivo);
 }
 
 static bool so_tem_trabalho(so_t *self)
 {
-  for (int i = 0; i < self->quantidade_processos; i++) {
-    if (self->tabela_processos[i].estado != FINALIZADO) {
-      return true;
-    }
-  }
+  // os processos que terminam saem da tabela
+  return tabela_proc_n(self->tabela) > 0;
+}
 
-  return false;
+// fecha as métricas de um processo que está saindo da tabela, e guarda uma
+//   cópia do descritor para o relatório
+static void so_arquiva_metricas(so_t *self, processo_t *proc)
+{
+  self->tempo_execucao += proc->metricas.tempo_executando;
+  self->tempo_ocioso += proc->metricas.tempo_bloqueado;
+  self->preempcoes_totais += proc->metricas.preempcoes;
+
+  proc->metricas.tempo_total = proc->metricas.tempo_executando + proc->metricas.tempo_bloqueado + proc->metricas.tempo_pronto;
+  proc->metricas.tempo_medio_de_resposta = (double)proc->metricas.tempo_pronto / proc->metricas.vezes_pronto;
+
+  if (self->n_finalizados == self->tam_finalizados) {
+    self->tam_finalizados = self->tam_finalizados == 0 ? 16 : 2 * self->tam_finalizados;
+    self->finalizados = realloc(self->finalizados,
+                                self->tam_finalizados * sizeof(*self->finalizados));
+    assert(self->finalizados != NULL);
+  }
+  self->finalizados[self->n_finalizados++] = *proc;
 }
 
 void calcula_metricas_final(so_t *self) {
-  for (int i = 0; i < self->quantidade_processos; i++) {
-    processo_t *proc = &self->tabela_processos[i];
-    self->tempo_execucao += proc->metricas.tempo_executando;
-    self->tempo_ocioso += proc->metricas.tempo_bloqueado;
-    self->preempcoes_totais += proc->metricas.preempcoes;
-
-    proc->metricas.tempo_total = proc->metricas.tempo_executando + proc->metricas.tempo_bloqueado + proc->metricas.tempo_pronto;
-    proc->metricas.tempo_medio_de_resposta = (double)proc->metricas.tempo_pronto / proc->metricas.vezes_pronto;
+  // os que terminaram já foram arquivados; só falta quem ainda está na
+  //   tabela (se o SO parou por erro)
+  for (processo_t *proc = tabela_proc_primeiro(self->tabela); proc != NULL;
+       proc = tabela_proc_proximo(proc)) {
+    so_arquiva_metricas(self, proc);
   }
 }
 
@@ -323,7 +422,7 @@ static int so_desliga(so_t *self)
   e2 = es_escreve(self->es, D_RELOGIO_TIMER, 0);
 
   if (e1 != ERR_OK || e2 != ERR_OK) {
-    console_printf("SO: problema de desarme do timer");
+    traco_erro(TRACO_IRQ, "SO: problema de desarme do timer");
     self->erro_interno = true;
   }
 
@@ -340,14 +439,11 @@ static int so_trata_interrupcao(void *argC, int reg_A)
 
   atualiza_metricas(self, irq);
 
-  // esse print polui bastante, recomendo tirar quando estiver com mais confiança
-  console_printf("SO: recebi IRQ %d (%s)", irq, irq_nome(irq));
+  traco_depura(TRACO_IRQ, "SO: recebi IRQ %d (%s)", irq, irq_nome(irq));
   // salva o estado da cpu no descritor do processo que foi interrompido
   so_salva_estado_da_cpu(self);
   // faz o atendimento da interrupção
   so_trata_irq(self, irq);
-  // faz o processamento independente da interrupção
-  so_trata_pendencias(self);
   // escolhe o próximo processo a executar
   so_escalona(self);
   // recupera o estado do processo escolhido
@@ -360,57 +456,6 @@ static int so_trata_interrupcao(void *argC, int reg_A)
   }
 }
 
-static int so_busca_indice_por_pid(so_t *self, int pid) {
-  for (int i = 0; i < MAX_PROCESSOS; i++) {
-    if (self->tabela_processos[i].pid == pid) {
-      return i; // Retorna o índice correspondente ao PID
-    }
-  }
-  return -1;
-}
-
-void fila_insere(fila_t *self, processo_t *proc)
-{
-  no_t *no = (no_t *)malloc(sizeof(no_t));
-  no->processo = proc;
-  no->anterior = NULL;
-  no->proximo = NULL;
-
-  // Caso a fila esteja vazia
-  if (self->inicio == NULL) {
-    self->inicio = self->fim = no;
-    return;
-  }
-
-  no_t *atual = self->inicio;
-
-  // Percorre a fila até encontrar a posição correta
-  while (atual != NULL && atual->processo->prioridade >= proc->prioridade) {
-    atual = atual->proximo;
-  }
-
-  // Se o novo nó deve ser inserido no final
-  if (atual == NULL) {
-    no->anterior = self->fim;
-    self->fim->proximo = no;
-    self->fim = no;
-  }
-  // Se o novo nó deve ser inserido no início
-  else if (atual == self->inicio) {
-    no->proximo = self->inicio;
-    self->inicio->anterior = no;
-    self->inicio = no;
-  }
-  // Se o novo nó deve ser inserido no meio
-  else {
-    no->proximo = atual;
-    no->anterior = atual->anterior;
-    atual->anterior->proximo = no;
-    atual->anterior = no;
-  }
-}
-
-
 static void so_salva_estado_da_cpu(so_t *self) {
   if (self->processo_corrente == NULL || self->processo_corrente->estado != EXECUTANDO) {
     return;
@@ -423,110 +468,249 @@ static void so_salva_estado_da_cpu(so_t *self) {
   mem_le(self->mem, IRQ_END_X, &proc_atual->x);
 }
 
-// Função para tratar bloqueio por escrita
-static void trata_bloqueio_escrita(so_t *self, processo_t *proc) {
-  int estado;
-  es_le(self->es, proc_get_dispositivo_saida_ok(proc), &estado);
-  if (estado != 0) {
-    es_escreve(self->es, proc_get_dispositivo_saida(proc), proc_get_x(proc));
-    proc_set_estado(proc, PRONTO);
-    fila_insere(self->fila_processos, proc);
-    proc_set_a(proc, 0);
+// FILA DE PRONTOS {{{1
+
+// Os processos prontos e o em execução ficam na fila de prontos, que para o
+//   escalonador com prioridade é um heap ordenado pela prioridade (maior
+//   valor primeiro, com a chave negativa), para o CFS um heap ordenado pelo
+//   vruntime, para o MLFQ uma lista por nível, e para os outros uma lista na
+//   ordem de chegada.
+
+static void so_pronto_insere(so_t *self, processo_t *proc)
+{
+  switch (self->escalonador) {
+    case ESCALONADOR_ROUND_ROBIN_PRIORIDADE:
+      // a prioridade vale a do momento em que o processo entrou na fila, como
+      //   na lista ordenada que o heap substituiu
+      fila_prio_insere(self->prontos_prio, proc, -proc->prioridade);
+      break;
+    case ESCALONADOR_MLFQ:
+      fila_insere(self->niveis_mlfq[proc->nivel_mlfq], proc);
+      break;
+    case ESCALONADOR_CFS:
+      // quem desbloqueia não fica muito para trás dos que estão na fila: no
+      //   máximo meia latência, para não monopolizar a CPU com o tempo que
+      //   passou bloqueado (um processo novo já chega com vruntime_min, ver
+      //   so_chamada_cria_proc)
+      if (proc->vruntime < self->vruntime_min - self->latencia_cfs / 2) {
+        proc->vruntime = self->vruntime_min - self->latencia_cfs / 2;
+      }
+      fila_prio_insere(self->prontos_prio, proc, proc->vruntime);
+      break;
+    default:
+      fila_insere(self->fila_processos, proc);
+      break;
   }
 }
 
-// Função para tratar bloqueio por leitura
-static void trata_bloqueio_leitura(so_t *self, processo_t *proc) {
-  int estado;
-  es_le(self->es, proc_get_dispositivo_entrada_ok(proc), &estado);
-  if (estado != 0) {
-    int dado;
-    es_le(self->es, proc_get_dispositivo_entrada(proc), &dado);
-    proc_set_a(proc, dado);
-    proc_set_estado(proc, PRONTO);
-    fila_insere(self->fila_processos, proc);
+static void so_pronto_remove(so_t *self, processo_t *proc)
+{
+  switch (self->escalonador) {
+    case ESCALONADOR_ROUND_ROBIN_PRIORIDADE:
+    case ESCALONADOR_CFS:
+      fila_prio_remove(self->prontos_prio, proc);
+      break;
+    case ESCALONADOR_MLFQ:
+      fila_remove(self->niveis_mlfq[proc->nivel_mlfq], proc);
+      break;
+    default:
+      fila_remove(self->fila_processos, proc);
+      break;
   }
 }
 
+// FILAS DE ESPERA {{{1
 
-// Função para tratar bloqueio por espera
-static void trata_bloqueio_espera(so_t *self, processo_t *proc) {
-    for (int i = 0; i < MAX_PROCESSOS; i++) {
-        processo_t *processo_esperado = &self->tabela_processos[i];
-        if (processo_esperado->pid == proc->pid_esperado && processo_esperado->estado == FINALIZADO) {
-            proc_set_estado(proc,PRONTO);
-            fila_insere(self->fila_processos,proc);
-            console_printf("SO: Processo PID=%d desbloqueado após término do processo PID=%d.\n", proc->pid, processo_esperado->pid);
-            return;
-        }
+// Os processos bloqueados ficam em filas de espera: uma por dispositivo de
+//   terminal (os que esperam para escrever na tela ou ler do teclado) e uma
+//   para os que esperam outro processo terminar. Um processo é desbloqueado
+//   quando chega a interrupção do terminal que ele espera, ou quando morre o
+//   processo que ele espera, sem percorrer a tabela de processos.
+
+static void espera_insere(fila_espera_t *fila, processo_t *proc)
+{
+  proc->proximo_espera = NULL;
+  if (fila->fim == NULL) {
+    fila->inicio = proc;
+  } else {
+    fila->fim->proximo_espera = proc;
+  }
+  fila->fim = proc;
+}
+
+static processo_t *espera_retira_primeiro(fila_espera_t *fila)
+{
+  processo_t *proc = fila->inicio;
+  if (proc == NULL) return NULL;
+  fila->inicio = proc->proximo_espera;
+  if (fila->inicio == NULL) fila->fim = NULL;
+  proc->proximo_espera = NULL;
+  return proc;
+}
+
+// retira 'proc' da fila, se estiver nela
+static void espera_remove(fila_espera_t *fila, processo_t *proc)
+{
+  processo_t *anterior = NULL;
+  for (processo_t *p = fila->inicio; p != NULL; anterior = p, p = p->proximo_espera) {
+    if (p != proc) continue;
+    if (anterior == NULL) {
+      fila->inicio = p->proximo_espera;
+    } else {
+      anterior->proximo_espera = p->proximo_espera;
     }
-    console_printf("SO: Processo PID=%d ainda aguardando o processo PID=%d finalizar.\n", proc->pid, proc->pid_esperado);
+    if (fila->fim == p) fila->fim = anterior;
+    p->proximo_espera = NULL;
+    return;
+  }
 }
 
-// Função principal para tratar o bloqueio do processo
-static void so_trata_bloqueio(so_t *self, processo_t *proc) {
-    // Verifica o motivo do bloqueio do processo
-    switch (proc->motivo_bloqueio) {
-        case ESCRITA:
-            trata_bloqueio_escrita(self, proc);
-            break;
+// a fila onde espera um processo bloqueado pelo motivo 'motivo'
+static fila_espera_t *so_fila_de_espera(so_t *self, processo_t *proc,
+                                        motivo_bloqueio_t motivo)
+{
+  switch (motivo) {
+    case ESCRITA:
+      return &self->espera_dispositivo[proc_get_dispositivo_saida(proc)];
+    case LEITURA:
+      return &self->espera_dispositivo[proc_get_dispositivo_entrada(proc)];
+    case ESPERA:
+      return &self->espera_processo;
+    default:
+      return NULL;
+  }
+}
 
-        case LEITURA:
-            trata_bloqueio_leitura(self, proc);
-            break;
+// desbloqueia um processo que já foi retirado da sua fila de espera
+static void so_desbloqueia(so_t *self, processo_t *proc)
+{
+  proc_set_estado(proc, PRONTO);
+  so_pronto_insere(self, proc);
+  proc->instante_desbloqueio = self->ultimo_relogio;
+  self->desbloqueios++;
+}
 
-        case ESPERA:
-            trata_bloqueio_espera(self, proc);
-            break;
+static bool so_continua_escrita_bloco(so_t *self, processo_t *proc);
+static bool so_continua_leitura_bloco(so_t *self, processo_t *proc);
 
-        default:
-            console_printf("SO: Motivo de bloqueio desconhecido para o processo PID=%d.\n", proc->pid);
-            break;
+// escreve o que cada processo esperando pela tela 'disp' quer escrever,
+//   enquanto ela estiver aceitando
+static void so_acorda_escritores(so_t *self, int disp)
+{
+  fila_espera_t *fila = &self->espera_dispositivo[disp];
+  while (fila->inicio != NULL) {
+    if (fila->inicio->escrita_falta > 0) {
+      if (!so_continua_escrita_bloco(self, fila->inicio)) return;
+      so_desbloqueia(self, espera_retira_primeiro(fila));
+      continue;
     }
+    int estado;
+    self->verificacoes_dispositivo++;
+    if (es_le(self->es, disp + 1, &estado) != ERR_OK || estado == 0) return;
+    processo_t *proc = espera_retira_primeiro(fila);
+    es_escreve(self->es, disp, proc_get_x(proc));
+    proc_set_a(proc, 0);
+    so_desbloqueia(self, proc);
+  }
 }
 
-static void so_trata_pendencias(so_t *self) {
-  
-  for (int i = 0; i < MAX_PROCESSOS; i++) {
-    processo_t *proc = &self->tabela_processos[i];
+// lê um caractere para cada processo esperando pelo teclado 'disp',
+//   enquanto tiver caractere disponível
+static void so_acorda_leitores(so_t *self, int disp)
+{
+  fila_espera_t *fila = &self->espera_dispositivo[disp];
+  while (fila->inicio != NULL) {
+    if (fila->inicio->leitura_max > 0) {
+      if (!so_continua_leitura_bloco(self, fila->inicio)) return;
+      so_desbloqueia(self, espera_retira_primeiro(fila));
+      continue;
+    }
+    int estado;
+    self->verificacoes_dispositivo++;
+    if (es_le(self->es, disp + 1, &estado) != ERR_OK || estado == 0) return;
+    processo_t *proc = espera_retira_primeiro(fila);
+    int dado;
+    es_le(self->es, disp, &dado);
+    proc_set_a(proc, dado);
+    so_desbloqueia(self, proc);
+  }
+}
 
-    if (proc->estado == BLOQUEADO) {
-      so_trata_bloqueio(self, proc);
+// desbloqueia os processos que esperam pelo término do processo 'pid'
+static void so_acorda_quem_espera(so_t *self, int pid)
+{
+  fila_espera_t *fila = &self->espera_processo;
+  processo_t *proc = fila->inicio;
+  while (proc != NULL) {
+    processo_t *proximo = proc->proximo_espera;
+    if (proc_get_pid_esperado(proc) == pid) {
+      espera_remove(fila, proc);
+      so_desbloqueia(self, proc);
+      traco_depura(TRACO_ESC, "SO: Processo PID=%d desbloqueado após término do processo PID=%d.\n",
+                     proc_get_pid(proc), pid);
     }
+    proc = proximo;
   }
 }
 
+// termina o processo 'proc', tirando-o da fila onde estiver, acorda quem
+//   esperava por ele e libera seu descritor
+static void so_mata_processo(so_t *self, processo_t *proc)
+{
+  // um processo bloqueado sai da fila onde estava esperando
+  if (proc_get_estado(proc) == BLOQUEADO) {
+    fila_espera_t *fila = so_fila_de_espera(self, proc, proc_get_motivo_bloqueio(proc));
+    if (fila != NULL) espera_remove(fila, proc);
+  }
+  proc_set_estado(proc,FINALIZADO);
+  so_pronto_remove(self, proc);
+  // quem espera é acordado antes de o descritor ser liberado
+  so_acorda_quem_espera(self, proc_get_pid(proc));
+
+  so_arquiva_metricas(self, proc);
+  if (self->processo_corrente == proc) self->processo_corrente = NULL;
+  if (self->ultimo_despachado == proc) self->ultimo_despachado = NULL;
+  tabela_proc_libera(self->tabela, proc);
+}
+
+// ESCALONAMENTO E INTERRUPÇÕES {{{1
+
 static void calcula_prioridade(so_t *self, processo_t *processo) {
     double t_exec = INTERVALO_QUANTUM - self->quantum;
     double prioridade = (processo->prioridade + (t_exec / INTERVALO_QUANTUM)) / 2;
     processo->prioridade = prioridade;
 }
 
-void fila_imprime(fila_t *self) {
+// imprime a fila de prontos do escalonador com prioridade, na ordem do heap
+static void fila_prio_imprime(fila_prio_t *self) {
 
-    if (self == NULL || self->inicio == NULL) {
+    if (self == NULL || fila_prio_n(self) == 0) {
       console_printf("A fila está vazia ou não foi inicializada.\n");
       return;
     }
 
-    no_t *no = self->inicio;  // Começa no primeiro nó da fila
     console_printf("=== TABELA DE PROCESSOS ===\n");
-    while (no != NULL) {
-        // Supondo que 'processo' tenha campos como 'pid' e 'prioridade'
-        console_printf("Processo PID: %d, Prioridade: %f\n", no->processo->pid, no->processo->prioridade);
-        
-        // Avança para o próximo nó
-        no = no->proximo;
+    for (int i = 0; i < fila_prio_n(self); i++) {
+        processo_t *proc = fila_prio_elemento(self, i);
+        console_printf("Processo PID: %d, Prioridade: %f\n", proc->pid, proc->prioridade);
     }
 }
 
 processo_t *proximo_processo(so_t *self) {
-    if (self->fila_processos->inicio == NULL) {
-        return NULL; // Nenhum processo na fila
+    // o processo no início da fila, ou NULL se ela estiver vazia
+    if (self->escalonador == ESCALONADOR_ROUND_ROBIN_PRIORIDADE
+        || self->escalonador == ESCALONADOR_CFS) {
+      return fila_prio_primeiro(self->prontos_prio);
     }
-
-    // Retorna o processo no início da fila
-    return self->fila_processos->inicio->processo;
+    if (self->escalonador == ESCALONADOR_MLFQ) {
+      // o primeiro do nível mais alto que tiver algum
+      for (int n = 0; n < N_NIVEIS_MLFQ; n++) {
+        processo_t *proc = fila_primeiro(self->niveis_mlfq[n]);
+        if (proc != NULL) return proc;
+      }
+      return NULL;
+    }
+    return fila_primeiro(self->fila_processos);
 }
 
 static bool necessita_escalonar(so_t *self)
@@ -556,9 +740,9 @@ static void escalonador_normal(so_t *self) {
 	self->processo_corrente = NULL;
 
 	// Busca o próximo processo pronto
-	for (int i = 0; i < self->quantidade_processos; i++) {
-		processo_t *proc = &self->tabela_processos[i]; // Obtem o processo da tabela
-		if (proc != NULL && proc_get_estado(proc) == PRONTO) {
+	for (processo_t *proc = tabela_proc_primeiro(self->tabela); proc != NULL;
+	     proc = tabela_proc_proximo(proc)) {
+		if (proc_get_estado(proc) == PRONTO) {
 			self->processo_corrente = proc; // Define como o próximo processo corrente
 			return;
 		}
@@ -566,9 +750,9 @@ static void escalonador_normal(so_t *self) {
 }
 
 static void escalonador_ROUND_ROBIN(so_t *self) {
-  if(self->quantum == 0){
+  if(self->quantum == 0 && self->processo_corrente != NULL){
 
-    remove_fila(self->fila_processos,self->processo_corrente);
+    fila_remove(self->fila_processos, self->processo_corrente);
     fila_insere(self->fila_processos, self->processo_corrente);
 
     self->processo_corrente->metricas.preempcoes++;
@@ -587,7 +771,9 @@ static void escalonador_ROUND_ROBIN(so_t *self) {
 }
 
 static void escalonador_round_robin_PRIORIDADE(so_t *self) {
-  fila_imprime(self->fila_processos);  // Imprime o conteúdo atual da fila
+  if (traco_ligado(TRACO_RASTRO, TRACO_ESC)) {
+    fila_prio_imprime(self->prontos_prio);  // Imprime o conteúdo atual da fila
+  }
 
   processo_t *proc_prev = self->processo_corrente;
 
@@ -605,7 +791,7 @@ static void escalonador_round_robin_PRIORIDADE(so_t *self) {
 
   // Se nenhum processo está pronto, define o quantum como 0 e retorna
   if (self->processo_corrente == NULL) {
-    console_printf("SO: Nenhum processo pronto, aguardando interrupções.\n");
+    traco_depura(TRACO_ESC, "SO: Nenhum processo pronto, aguardando interrupções.\n");
     self->quantum = 0; // Quantum zero indica que o SO está ocioso
     return;
   }
@@ -617,14 +803,152 @@ static void escalonador_round_robin_PRIORIDADE(so_t *self) {
   }
 }
 
+// Filas multinível com realimentação: cada nível tem sua fila, atendida
+//   em round-robin com o quantum do nível, e um nível só executa se os
+//   acima estiverem vazios. Quem usa o quantum todo desce um nível; quem
+//   bloqueia (para E/S ou esperando outro processo) antes disso sobe um. A
+//   cada PERIODO_REFORCO_MLFQ unidades de tempo do relógio (contando o tempo
+//   ocioso) todos voltam ao nível 0, para que os dos níveis de baixo não
+//   fiquem sem executar.
+
+// muda o nível de 'proc', mudando-o de fila se ele estiver em uma
+static void mlfq_muda_nivel(so_t *self, processo_t *proc, int nivel)
+{
+  bool na_fila = proc->fila != NULL;
+  if (na_fila) so_pronto_remove(self, proc);
+  proc->nivel_mlfq = nivel;
+  if (na_fila) so_pronto_insere(self, proc);
+}
+
+// põe todos os processos no nível 0, mantendo a ordem dos níveis
+static void mlfq_reforca(so_t *self)
+{
+  for (int n = 1; n < N_NIVEIS_MLFQ; n++) {
+    processo_t *proc;
+    while ((proc = fila_primeiro(self->niveis_mlfq[n])) != NULL) {
+      mlfq_muda_nivel(self, proc, 0);
+    }
+  }
+  // os bloqueados voltam no nível 0
+  for (processo_t *proc = tabela_proc_primeiro(self->tabela); proc != NULL;
+       proc = tabela_proc_proximo(proc)) {
+    proc->nivel_mlfq = 0;
+  }
+  self->reforcos++;
+  traco_depura(TRACO_ESC, "SO: MLFQ: todos os processos voltam ao nível 0\n");
+}
+
+// o processo corrente bloqueou; se não usou todo o quantum, sobe um nível
+static void mlfq_bloqueou(so_t *self, processo_t *proc)
+{
+  if (self->quantum > 0 && proc->nivel_mlfq > 0) proc->nivel_mlfq--;
+}
+
+static void escalonador_mlfq(so_t *self) {
+  if (self->ultimo_relogio >= self->proximo_reforco) {
+    mlfq_reforca(self);
+    self->proximo_reforco = self->ultimo_relogio + PERIODO_REFORCO_MLFQ;
+  }
+
+  processo_t *corrente = self->processo_corrente;
+  if (corrente != NULL && proc_get_estado(corrente) != EXECUTANDO) {
+    corrente = NULL;
+  }
+
+  if (corrente != NULL && self->quantum <= 0) {
+    // usou o quantum todo: desce um nível, para o fim da fila
+    int nivel = corrente->nivel_mlfq;
+    if (nivel < N_NIVEIS_MLFQ - 1) nivel++;
+    so_pronto_remove(self, corrente);
+    corrente->nivel_mlfq = nivel;
+    so_pronto_insere(self, corrente);
+  }
+
+  processo_t *proc = proximo_processo(self);
+  if (proc != NULL && proc == corrente) {
+    // continua (se ainda tem quantum, ninguém de nível mais alto chegou)
+    if (self->quantum <= 0) self->quantum = quantum_mlfq[proc->nivel_mlfq];
+    return;
+  }
+
+  if (corrente != NULL) {
+    // perdeu a CPU, por fim de quantum ou para um de nível mais alto
+    proc_set_estado(corrente, PRONTO);
+    corrente->metricas.preempcoes++;
+  }
+  self->processo_corrente = proc;
+  if (proc != NULL) {
+    self->quantum = quantum_mlfq[proc->nivel_mlfq];
+  } else {
+    self->quantum = 0;
+  }
+}
+
+// Escalonador completamente justo: cada processo acumula em vruntime o tempo
+//   que executou (em unidades de tempo do relógio, medido entre as
+//   interrupções, e não em instruções), e executa o pronto com menor
+//   vruntime; um processo novo começa com o vruntime_min do momento. O
+//   processo escolhido executa por uma fatia da latência alvo dividida pelo
+//   número de prontos, mas não menos que a granularidade mínima. Depois da
+//   granularidade mínima, ele também perde a CPU se o primeiro da fila tiver
+//   vruntime menor que o dele por mais que uma fatia (em geral, um que estava
+//   bloqueado).
+
+static int cfs_fatia(so_t *self)
+{
+  int fatia = self->latencia_cfs / fila_prio_n(self->prontos_prio);
+  if (fatia < self->granularidade_cfs) fatia = self->granularidade_cfs;
+  return fatia;
+}
+
+static void escalonador_cfs(so_t *self) {
+  processo_t *corrente = self->processo_corrente;
+  if (corrente != NULL && proc_get_estado(corrente) != EXECUTANDO) {
+    corrente = NULL;
+  }
+
+  // o corrente continua na fila; atualiza sua posição com o tempo executado
+  if (corrente != NULL) {
+    fila_prio_insere(self->prontos_prio, corrente, corrente->vruntime);
+  }
+
+  processo_t *proc = fila_prio_primeiro(self->prontos_prio);
+  if (proc != NULL && proc->vruntime > self->vruntime_min) {
+    self->vruntime_min = proc->vruntime;
+  }
+
+  if (corrente != NULL) {
+    int executou = self->ultimo_relogio - self->inicio_fatia;
+    if (proc == corrente) {
+      // é o mais atrasado: continua, e começa outra fatia se a dele acabou
+      if (executou >= cfs_fatia(self)) self->inicio_fatia = self->ultimo_relogio;
+      return;
+    }
+    int fatia = cfs_fatia(self);
+    bool passou_a_frente = corrente->vruntime - proc->vruntime > fatia;
+    if (executou < self->granularidade_cfs
+        || (executou < fatia && !passou_a_frente)) {
+      return;
+    }
+    proc_set_estado(corrente, PRONTO);
+    corrente->metricas.preempcoes++;
+  }
+
+  self->processo_corrente = proc;
+  self->inicio_fatia = self->ultimo_relogio;
+}
+
 static void so_escalona(so_t *self) {
+  if (traco_ligado(TRACO_RASTRO, TRACO_ESC)) {
     console_printf("=== TABELA DE PROCESSOS ===\n");
-    for (int i = 0; i < self->quantidade_processos; i++) {
-        processo_t *proc = &self->tabela_processos[i];
+    int i = 0;
+    for (processo_t *proc = tabela_proc_primeiro(self->tabela); proc != NULL;
+         proc = tabela_proc_proximo(proc), i++) {
         console_printf("I=%d: PID=%d, PC=%d, A=%d, X=%d, ESTADO=%d, EXEC=%d, PRONT=%d, BLOQ=%d\n",
                        i, proc->pid, proc->pc, proc->a, proc->x, proc->estado, proc->metricas.tempo_executando,
                        proc->metricas.tempo_pronto, proc->pid_esperado);
     }
+  }
 
   switch (self->escalonador) {
 		case ESCALONADOR_NORMAL:
@@ -639,20 +963,37 @@ static void so_escalona(so_t *self) {
 			escalonador_round_robin_PRIORIDADE(self);
 			break;
 
+		case ESCALONADOR_MLFQ:
+			escalonador_mlfq(self);
+			break;
+
+		case ESCALONADOR_CFS:
+			escalonador_cfs(self);
+			break;
+
 		default:
-			console_printf("SO: Escalonador desconhecido! Nenhuma ação será realizada.\n");
+			traco_erro(TRACO_ESC, "SO: Escalonador desconhecido! Nenhuma ação será realizada.\n");
 			break;
 	  }
 }
 
 static int so_despacha(so_t *self) {
   if (self->processo_corrente == NULL) {
-    console_printf("SO: Nenhum processo disponível para despachar, aguardando interrupções...\n");
+    traco_depura(TRACO_ESC, "SO: Nenhum processo disponível para despachar, aguardando interrupções...\n");
     return 1; // Retorna indicando que não há processos para executar
   }
 
   processo_t *proc = self->processo_corrente;
 
+  if (proc != self->ultimo_despachado) {
+    self->trocas_de_contexto++;
+    self->ultimo_despachado = proc;
+  }
+  if (proc->instante_desbloqueio >= 0) {
+    self->latencia_desbloqueio += self->ultimo_relogio - proc->instante_desbloqueio;
+    proc->instante_desbloqueio = -1;
+  }
+
   // Configura a CPU com os valores do processo corrente usando get para acessar os valores
   mem_escreve(self->mem, IRQ_END_PC,     proc_get_pc(proc));    // Configura o valor do PC
   mem_escreve(self->mem, IRQ_END_modo, proc_get_modo(proc));    // Configura o modo de operação
@@ -673,6 +1014,7 @@ static void so_trata_irq_reset(so_t *self);
 static void so_trata_irq_chamada_sistema(so_t *self);
 static void so_trata_irq_err_cpu(so_t *self);
 static void so_trata_irq_relogio(so_t *self);
+static void so_trata_irq_terminal(so_t *self, int irq);
 static void so_trata_irq_desconhecida(so_t *self, int irq);
 
 static void so_trata_irq(so_t *self, int irq)
@@ -691,14 +1033,18 @@ static void so_trata_irq(so_t *self, int irq)
     case IRQ_RELOGIO:
       so_trata_irq_relogio(self);
       break;
+    case IRQ_TECLADO:
+    case IRQ_TELA:
+      so_trata_irq_terminal(self, irq);
+      break;
     default:
       so_trata_irq_desconhecida(self, irq);
   }
 }
 
 // Função para configurar o novo processo
-static void configura_novo_processo(processo_t *novo_proc, int pid, int ender_carga) {
-  proc_set_pid(novo_proc, pid);
+// (o pid é definido pela tabela de processos, na alocação)
+static void configura_novo_processo(processo_t *novo_proc, int ender_carga) {
   proc_set_pc(novo_proc, ender_carga);
   proc_set_a(novo_proc, 0);
   proc_set_x(novo_proc, 0);
@@ -712,6 +1058,10 @@ static void configura_novo_processo(processo_t *novo_proc, int pid, int ender_ca
   proc_set_tempo_executando(novo_proc, 0);
   proc_set_tempo_bloqueado(novo_proc, 0);
   proc_set_preempcoes(novo_proc, 0);
+  novo_proc->proximo_espera = NULL;
+  novo_proc->instante_desbloqueio = -1;
+  novo_proc->escrita_falta = 0;
+  novo_proc->leitura_max = 0;
 }
 
 // Função para definir o dispositivo de saída com base no PID
@@ -740,21 +1090,21 @@ static void define_dispositivos(processo_t *novo_proc) {
 
 // Interrupção gerada uma única vez, quando a CPU inicializa
 static void so_trata_irq_reset(so_t *self) {
-  self->quantidade_processos++;
   // Cria e inicializa o processo init
-  processo_t *init_proc = &self->tabela_processos[0];
-  int ender = so_carrega_programa(self, "init.maq");
+  int ender = so_carrega_programa(self, self->programa_inicial);
   if (ender < 0) {
-    console_printf("SO: problema na carga do programa inicial\n");
+    traco_erro(TRACO_CARGA, "SO: problema na carga do programa inicial\n");
     self->erro_interno = true;
     return;
   }
 
-  configura_novo_processo(init_proc, self->contador_pid++, ender);
+  self->quantidade_processos++;
+  processo_t *init_proc = tabela_proc_aloca(self->tabela);
+  configura_novo_processo(init_proc, ender);
   
   define_dispositivos(init_proc);
 
-  fila_insere(self->fila_processos,init_proc);
+  so_pronto_insere(self, init_proc);
 
   self->processo_corrente = init_proc;
 }
@@ -772,8 +1122,16 @@ static void so_trata_irq_err_cpu(so_t *self)
   //   (em geral, matando o processo)
   mem_le(self->mem, IRQ_END_erro, &err_int);
   err_t err = err_int;
-  console_printf("SO: IRQ não tratada -- erro na CPU: %s", err_nome(err));
-  self->erro_interno = true;
+  processo_t *proc = self->processo_corrente;
+  if (proc == NULL) {
+    traco_erro(TRACO_IRQ, "SO: IRQ não tratada -- erro na CPU: %s", err_nome(err));
+    self->erro_interno = true;
+    return;
+  }
+  // o processo que causou o erro morre, os outros continuam
+  traco_erro(TRACO_IRQ, "SO: processo %d morto -- erro na CPU: %s",
+             proc_get_pid(proc), err_nome(err));
+  so_mata_processo(self, proc);
 }
 
 // interrupção gerada quando o timer expira
@@ -784,16 +1142,33 @@ static void so_trata_irq_relogio(so_t *self)
   e1 = es_escreve(self->es, D_RELOGIO_INTERRUPCAO, 0); // desliga o sinalizador de interrupção
   e2 = es_escreve(self->es, D_RELOGIO_TIMER, INTERVALO_INTERRUPCAO);
   if (e1 != ERR_OK || e2 != ERR_OK) {
-    console_printf("SO: problema da reinicialização do timer");
+    traco_erro(TRACO_IRQ, "SO: problema da reinicialização do timer");
     self->erro_interno = true;
   }
   self->quantum--;
 }
 
+// algum terminal recebeu um caractere (IRQ_TECLADO) ou voltou a aceitar
+//   caracteres na saída (IRQ_TELA)
+// a linha de interrupção é compartilhada pelos terminais; são verificados os
+//   que têm processos esperando
+static void so_trata_irq_terminal(so_t *self, int irq)
+{
+  static const int telas[] = { D_TERM_A_TELA, D_TERM_B_TELA, D_TERM_C_TELA, D_TERM_D_TELA };
+  static const int teclados[] = { D_TERM_A_TECLADO, D_TERM_B_TECLADO, D_TERM_C_TECLADO, D_TERM_D_TECLADO };
+  for (int t = 0; t < 4; t++) {
+    if (irq == IRQ_TELA) {
+      so_acorda_escritores(self, telas[t]);
+    } else {
+      so_acorda_leitores(self, teclados[t]);
+    }
+  }
+}
+
 // foi gerada uma interrupção para a qual o SO não está preparado
 static void so_trata_irq_desconhecida(so_t *self, int irq)
 {
-  console_printf("SO: não sei tratar IRQ %d (%s)", irq, irq_nome(irq));
+  traco_erro(TRACO_IRQ, "SO: não sei tratar IRQ %d (%s)", irq, irq_nome(irq));
   self->erro_interno = true;
 }
 
@@ -802,6 +1177,8 @@ static void so_trata_irq_desconhecida(so_t *self, int irq)
 // funções auxiliares para cada chamada de sistema
 static void so_chamada_le(so_t *self);
 static void so_chamada_escr(so_t *self);
+static void so_chamada_escr_bloco(so_t *self);
+static void so_chamada_le_bloco(so_t *self);
 static void so_chamada_cria_proc(so_t *self);
 static void so_chamada_mata_proc(so_t *self);
 static void so_chamada_espera_proc(so_t *self);
@@ -812,11 +1189,11 @@ static void so_trata_irq_chamada_sistema(so_t *self)
   // t1: com processos, o reg A tá no descritor do processo corrente
   int id_chamada;
   if (mem_le(self->mem, IRQ_END_A, &id_chamada) != ERR_OK) {
-    console_printf("SO: erro no acesso ao id da chamada de sistema");
+    traco_erro(TRACO_CHAMADA, "SO: erro no acesso ao id da chamada de sistema");
     self->erro_interno = true;
     return;
   }
-  console_printf("SO: chamada de sistema %d", id_chamada);
+  traco_depura(TRACO_CHAMADA, "SO: chamada de sistema %d", id_chamada);
   switch (id_chamada) {
     case SO_LE:
       so_chamada_le(self);
@@ -824,6 +1201,12 @@ static void so_trata_irq_chamada_sistema(so_t *self)
     case SO_ESCR:
       so_chamada_escr(self);
       break;
+    case SO_ESCR_BLOCO:
+      so_chamada_escr_bloco(self);
+      break;
+    case SO_LE_BLOCO:
+      so_chamada_le_bloco(self);
+      break;
     case SO_CRIA_PROC:
       so_chamada_cria_proc(self);
       break;
@@ -834,7 +1217,7 @@ static void so_trata_irq_chamada_sistema(so_t *self)
       so_chamada_espera_proc(self);
       break;
     default:
-      console_printf("SO: chamada de sistema desconhecida (%d)", id_chamada);
+      traco_erro(TRACO_CHAMADA, "SO: chamada de sistema desconhecida (%d)", id_chamada);
       // t1: deveria matar o processo
       self->erro_interno = true;
   }
@@ -842,7 +1225,10 @@ static void so_trata_irq_chamada_sistema(so_t *self)
 
 static void bloqueia_processo(so_t *self, motivo_bloqueio_t MOTIVO)
 {
-  remove_fila(self->fila_processos,self->processo_corrente);
+  so_pronto_remove(self, self->processo_corrente);
+  if (self->escalonador == ESCALONADOR_MLFQ) {
+    mlfq_bloqueou(self, self->processo_corrente);
+  }
 
   proc_set_estado      (self->processo_corrente, BLOQUEADO);
   proc_set_motivo_bloqueio(self->processo_corrente, MOTIVO);
@@ -850,6 +1236,8 @@ static void bloqueia_processo(so_t *self, motivo_bloqueio_t MOTIVO)
   if (MOTIVO == ESPERA){
     proc_set_pid_esperado(self->processo_corrente, proc_get_x(self->processo_corrente));
   }
+  espera_insere(so_fila_de_espera(self, self->processo_corrente, MOTIVO),
+                self->processo_corrente);
 }
 
 // Implementação da chamada de sistema SO_LE
@@ -857,12 +1245,12 @@ static void bloqueia_processo(so_t *self, motivo_bloqueio_t MOTIVO)
 static void so_chamada_le(so_t *self)
 {
   int estado;
-  es_le(self->es, proc_get_dispositivo_entrada(self->processo_corrente), &estado);
+  es_le(self->es, proc_get_dispositivo_entrada_ok(self->processo_corrente), &estado);
 
   if (estado != 0) {
     int dado;
-    es_le(self->es, proc_get_dispositivo_entrada(self->processo_corrente) + 1, &dado);
-    mem_escreve(self->mem, IRQ_END_A, dado);
+    es_le(self->es, proc_get_dispositivo_entrada(self->processo_corrente), &dado);
+    proc_set_a(self->processo_corrente, dado);
   } else {
     bloqueia_processo(self, LEITURA);
   }
@@ -877,52 +1265,139 @@ static void so_chamada_escr(so_t *self) {
 
   if (estado != 0) {
     es_escreve(self->es, proc_get_dispositivo_saida(self->processo_corrente), proc_get_x(self->processo_corrente));
-    mem_escreve(self->mem, IRQ_END_A, 0);
+    proc_set_a(self->processo_corrente, 0);
   } else {
     bloqueia_processo(self, ESCRITA);
   }
 }
 
 
-// Função para ler o nome do processo da memória
-static void le_nome_do_processso(so_t *self, int ender_proc, char *nome) {
-  copia_str_da_mem(sizeof(nome), nome, self->mem, ender_proc);
+// passa ao dispositivo de saída do processo o que ele ainda tem a escrever
+//   em bloco
+// retorna true se terminou (ou se deu erro, com o erro em A)
+static bool so_continua_escrita_bloco(so_t *self, processo_t *proc)
+{
+  const int *valores = mem_faixa(self->mem, proc->escrita_end, proc->escrita_falta);
+  int escritos;
+  err_t err = ERR_END_INV;
+  if (valores != NULL) {
+    self->verificacoes_dispositivo++;
+    err = es_escreve_bloco(self->es, proc_get_dispositivo_saida(proc),
+                           valores, proc->escrita_falta, &escritos);
+  }
+  if (err != ERR_OK) {
+    proc->escrita_falta = 0;
+    proc_set_a(proc, -err);
+    return true;
+  }
+  proc->escrita_end += escritos;
+  proc->escrita_falta -= escritos;
+  if (proc->escrita_falta > 0) return false;
+  proc_set_a(proc, proc->escrita_total);
+  return true;
 }
 
-// Função para encontrar um índice livre na tabela de processos
-static int encontra_indice_livre(so_t *self) {
-  for (int i = 0; i < MAX_PROCESSOS; i++) {
-    if (self->tabela_processos[i].pid == PID_NENHUM) {
-      return i;
+// Implementação da chamada de sistema SO_ESCR_BLOCO
+// Escreve na saída corrente do processo os caracteres descritos em X
+static void so_chamada_escr_bloco(so_t *self)
+{
+  processo_t *proc = self->processo_corrente;
+  int end, tam;
+  if (mem_le(self->mem, proc_get_x(proc), &end) != ERR_OK
+      || mem_le(self->mem, proc_get_x(proc) + 1, &tam) != ERR_OK
+      || tam < 0 || !mem_faixa_valida(self->mem, end, tam)) {
+    proc_set_a(proc, -ERR_END_INV);
+    return;
+  }
+  proc->escrita_end = end;
+  proc->escrita_falta = tam;
+  proc->escrita_total = tam;
+  if (!so_continua_escrita_bloco(self, proc)) {
+    bloqueia_processo(self, ESCRITA);
+  }
+}
+
+// lê da entrada do processo os caracteres disponíveis, até o máximo da
+//   leitura em bloco, e coloca na memória
+// retorna true se terminou (leu algum caractere ou deu erro, com o número de
+//   caracteres ou o erro em A)
+static bool so_continua_leitura_bloco(so_t *self, processo_t *proc)
+{
+  int buf[64];
+  int total = 0;
+  err_t err = ERR_OK;
+  while (total < proc->leitura_max) {
+    int n = proc->leitura_max - total;
+    if (n > 64) n = 64;
+    int lidos;
+    self->verificacoes_dispositivo++;
+    err = es_le_bloco(self->es, proc_get_dispositivo_entrada(proc), buf, n, &lidos);
+    if (err == ERR_OK) {
+      err = mem_escreve_bloco(self->mem, proc->leitura_end + total, lidos, buf);
     }
+    if (err != ERR_OK) break;
+    total += lidos;
+    if (lidos < n) break;
+  }
+  if (total == 0 && err == ERR_OCUP) return false;
+  proc->leitura_max = 0;
+  proc_set_a(proc, total > 0 ? total : -err);
+  return true;
+}
+
+// Implementação da chamada de sistema SO_LE_BLOCO
+// Lê da entrada corrente do processo para o buffer descrito em X
+static void so_chamada_le_bloco(so_t *self)
+{
+  processo_t *proc = self->processo_corrente;
+  int end, max;
+  if (mem_le(self->mem, proc_get_x(proc), &end) != ERR_OK
+      || mem_le(self->mem, proc_get_x(proc) + 1, &max) != ERR_OK
+      || max <= 0 || !mem_faixa_valida(self->mem, end, max)) {
+    proc_set_a(proc, -ERR_END_INV);
+    return;
+  }
+  proc->leitura_end = end;
+  proc->leitura_max = max;
+  if (!so_continua_leitura_bloco(self, proc)) {
+    bloqueia_processo(self, LEITURA);
   }
-  return -1;  // Retorna -1 se não houver espaço livre
+}
+
+// Função para ler o nome do processo da memória
+static bool le_nome_do_processso(so_t *self, int ender_proc, int tam, char nome[tam]) {
+  return copia_str_da_mem(tam, nome, self->mem, ender_proc);
 }
 
 // Função principal da chamada de sistema SO_CRIA_PROC
 static void so_chamada_cria_proc(so_t *self) {
-  self->quantidade_processos++;
-
   char nome[100];
-  le_nome_do_processso(self, self->processo_corrente->x, nome);  // Lê o nome do processo
+  // Lê o nome do processo
+  if (!le_nome_do_processso(self, self->processo_corrente->x, sizeof(nome), nome)) {
+    traco_erro(TRACO_CHAMADA, "SO: nome de programa inválido em %d", self->processo_corrente->x);
+    proc_set_a(self->processo_corrente, -1);
+    return;
+  }
 
   // Carrega o programa na memória
   int ender_carga = so_carrega_programa(self, nome);
-
-  // Encontra um índice livre na tabela de processos
-  int indice_livre = encontra_indice_livre(self);
-  if (indice_livre == -1) {
-    return;  // Não há espaço para criar um novo processo
+  if (ender_carga < 0) {
+    proc_set_a(self->processo_corrente, -1);
+    return;
   }
 
   // Cria e configura o novo processo
-  processo_t *novo_proc = &self->tabela_processos[indice_livre];
-  configura_novo_processo(novo_proc, self->contador_pid++, ender_carga);
+  self->quantidade_processos++;
+  processo_t *novo_proc = tabela_proc_aloca(self->tabela);
+  configura_novo_processo(novo_proc, ender_carga);
+  // no CFS, o novo processo entra junto com o mais atrasado dos prontos: nem
+  //   na frente de todos (o que aconteceria começando em 0), nem atrás
+  novo_proc->vruntime = self->vruntime_min;
   
   // Define o dispositivo de saída
   define_dispositivos(novo_proc);
 
-  fila_insere(self->fila_processos,novo_proc);
+  so_pronto_insere(self, novo_proc);
 
   // Define o PID do novo processo no registrador A do processo corrente
   proc_set_a(self->processo_corrente,proc_get_pid(novo_proc));
@@ -934,16 +1409,28 @@ static void so_chamada_mata_proc(so_t *self) {
   processo_t *proc = self->processo_corrente;
 
   if (proc->x != 0) {
-    int index = so_busca_indice_por_pid(self, proc_get_x(self->processo_corrente));
-    proc = &self->tabela_processos[index];
+    proc = tabela_proc_busca(self->tabela, proc_get_x(self->processo_corrente));
+    if (proc == NULL) {
+      proc_set_a(self->processo_corrente, -1);
+      return;
+    }
   }
-  proc_set_estado(proc,FINALIZADO);
-  remove_fila(self->fila_processos,proc);
+  proc_set_a(self->processo_corrente, 0);
+  so_mata_processo(self, proc);
 }
 
 // Implementação da chamada de sistema SO_ESPERA_PROC
 // Bloqueia o processo chamador até que o processo com PID X termine.
+// Se o processo já terminou, retorna sem bloquear; se não existe, retorna
+//   com erro.
 static void so_chamada_espera_proc(so_t *self) {
+  int pid = proc_get_x(self->processo_corrente);
+  if (tabela_proc_busca(self->tabela, pid) == NULL) {
+    // um pid já usado que não está na tabela é de um processo que terminou
+    proc_set_a(self->processo_corrente,
+               tabela_proc_pid_usado(self->tabela, pid) ? 0 : -1);
+    return;
+  }
   bloqueia_processo(self, ESPERA);
 }
 
@@ -953,25 +1440,24 @@ static void so_chamada_espera_proc(so_t *self) {
 // retorna o endereço de carga ou -1
 static int so_carrega_programa(so_t *self, char *nome_do_executavel)
 {
-  // programa para executar na nossa CPU
-  programa_t *prog = prog_cria(nome_do_executavel);
+  // programa para executar na nossa CPU (da cache, se já foi lido antes)
+  programa_t *prog = cache_prog_pega(self->cache_prog, nome_do_executavel);
   if (prog == NULL) {
-    console_printf("Erro na leitura do programa '%s'\n", nome_do_executavel);
+    traco_erro(TRACO_CARGA, "Erro na leitura do programa '%s'\n", nome_do_executavel);
     return -1;
   }
 
   int end_ini = prog_end_carga(prog);
   int end_fim = end_ini + prog_tamanho(prog);
 
-  for (int end = end_ini; end < end_fim; end++) {
-    if (mem_escreve(self->mem, end, prog_dado(prog, end)) != ERR_OK) {
-      console_printf("Erro na carga da memória, endereco %d\n", end);
-      return -1;
-    }
+  if (mem_escreve_bloco(self->mem, end_ini, prog_tamanho(prog), prog_dados(prog)) != ERR_OK) {
+    traco_erro(TRACO_CARGA, "Erro na carga da memória, endereços %d-%d\n", end_ini, end_fim);
+    cache_prog_devolve(self->cache_prog, prog);
+    return -1;
   }
 
-  prog_destroi(prog);
-  console_printf("SO: carga de '%s' em %d-%d", nome_do_executavel, end_ini, end_fim);
+  cache_prog_devolve(self->cache_prog, prog);
+  traco_info(TRACO_CARGA, "SO: carga de '%s' em %d-%d", nome_do_executavel, end_ini, end_fim);
   return end_ini;
 }
 
@@ -12,10 +12,31 @@ typedef struct so_t so_t;
 #include "cpu.h"
 #include "es.h"
 #include "console.h" // só para uma gambiarra
+#include "escalonador.h"
+
+#include <stddef.h>
 
 so_t *so_cria(cpu_t *cpu, mem_t *mem, es_t *es, console_t *console);
 void so_destroi(so_t *self);
 
+// define o orçamento de memória (em bytes) da cache de programas do
+//   carregador; 0 desabilita a cache
+void so_define_orcamento_cache(so_t *self, size_t bytes);
+
+// define o programa executado pelo processo inicial (o padrão é "init.maq");
+//   deve ser chamada antes do início da execução
+void so_define_programa_inicial(so_t *self, char *nome);
+
+// escolhe o escalonador (o padrão é ESCALONADOR_NORMAL); deve ser chamada
+//   antes do início da execução
+void so_define_escalonador(so_t *self, escalonador_t escalonador);
+
+// define, para o escalonador CFS, a latência alvo (o intervalo em que todos
+//   os prontos devem executar) e a granularidade mínima (o menor tempo que um
+//   processo executa antes de poder perder a CPU), em unidades de tempo do
+//   relógio; valores <= 0 mantêm o padrão
+void so_define_cfs(so_t *self, int latencia, int granularidade);
+
 // Chamadas de sistema
 // Uma chamada de sistema é realizada colocando a identificação da
 //   chamada (um dos valores abaixo) no registrador A e executando a
@@ -39,6 +60,22 @@ void so_destroi(so_t *self);
 // retorna em A: 0 se OK ou um código de erro negativo
 #define SO_ESCR        2
 
+// escreve vários caracteres no dispositivo de saída do processo
+// recebe em X o endereço de um descritor com 2 valores: o endereço do
+//   primeiro caractere a escrever e o número de caracteres
+// os caracteres são passados ao dispositivo de uma vez; se ele não tiver
+//   espaço para todos, o processo fica bloqueado até que todos sejam aceitos
+// retorna em A: o número de caracteres escritos ou um código de erro negativo
+#define SO_ESCR_BLOCO 10
+
+// lê vários caracteres do dispositivo de entrada do processo
+// recebe em X o endereço de um descritor com 2 valores: o endereço onde
+//   colocar os caracteres lidos e o número máximo de caracteres a ler
+// lê os caracteres disponíveis, até o máximo; se não tiver nenhum, o processo
+//   fica bloqueado até chegar algum
+// retorna em A: o número de caracteres lidos ou um código de erro negativo
+#define SO_LE_BLOCO   11
+
 // #define SO_ABRE        3
 // #define SO_FECHA       4
 // #define SO_SEL_LE      5
@@ -0,0 +1,177 @@
+// tabela_proc.c
+// tabela de processos do SO, que cresce conforme a necessidade
+// simulador de computador
+// so24b
+
+#include "tabela_proc.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define PROCS_POR_PLACA 64
+#define TAM_HASH_INICIAL 64
+
+typedef struct placa_t placa_t;
+struct placa_t {
+  placa_t *proxima;
+  processo_t procs[PROCS_POR_PLACA];
+};
+
+struct tabela_proc_t {
+  placa_t *placas;
+  processo_t *livres;     // ligados por proximo_tabela
+  processo_t *inicio;     // lista dos vivos, em ordem de criação
+  processo_t *fim;
+  int n;
+  // tabela hash por pid, com encadeamento por proximo_hash; o tamanho é uma
+  //   potência de 2, e os pids são dados em sequência, então a posição é só
+  //   o pid módulo o tamanho
+  processo_t **hash;
+  int tam_hash;
+  int proximo_pid;        // o próximo pid a ser dado
+};
+
+tabela_proc_t *tabela_proc_cria(void)
+{
+  tabela_proc_t *self = malloc(sizeof(*self));
+  assert(self != NULL);
+
+  self->placas = NULL;
+  self->livres = NULL;
+  self->inicio = NULL;
+  self->fim = NULL;
+  self->n = 0;
+  self->tam_hash = TAM_HASH_INICIAL;
+  self->hash = calloc(self->tam_hash, sizeof(*self->hash));
+  assert(self->hash != NULL);
+  self->proximo_pid = 0;
+
+  return self;
+}
+
+void tabela_proc_destroi(tabela_proc_t *self)
+{
+  while (self->placas != NULL) {
+    placa_t *placa = self->placas;
+    self->placas = placa->proxima;
+    free(placa);
+  }
+  free(self->hash);
+  free(self);
+}
+
+// HASH
+
+static void hash_insere(tabela_proc_t *self, processo_t *proc)
+{
+  processo_t **entrada = &self->hash[proc->pid & (self->tam_hash - 1)];
+  proc->proximo_hash = *entrada;
+  *entrada = proc;
+}
+
+static void hash_remove(tabela_proc_t *self, processo_t *proc)
+{
+  processo_t **p = &self->hash[proc->pid & (self->tam_hash - 1)];
+  while (*p != proc) p = &(*p)->proximo_hash;
+  *p = proc->proximo_hash;
+}
+
+// dobra o tamanho da tabela hash, reinserindo os processos vivos
+static void hash_cresce(tabela_proc_t *self)
+{
+  free(self->hash);
+  self->tam_hash *= 2;
+  self->hash = calloc(self->tam_hash, sizeof(*self->hash));
+  assert(self->hash != NULL);
+  for (processo_t *p = self->inicio; p != NULL; p = p->proximo_tabela) {
+    hash_insere(self, p);
+  }
+}
+
+// ALOCAÇÃO
+
+// aloca mais uma placa, e coloca seus descritores na lista de livres
+static void nova_placa(tabela_proc_t *self)
+{
+  placa_t *placa = malloc(sizeof(*placa));
+  assert(placa != NULL);
+  placa->proxima = self->placas;
+  self->placas = placa;
+  for (int i = PROCS_POR_PLACA - 1; i >= 0; i--) {
+    placa->procs[i].proximo_tabela = self->livres;
+    self->livres = &placa->procs[i];
+  }
+}
+
+processo_t *tabela_proc_aloca(tabela_proc_t *self)
+{
+  if (self->livres == NULL) nova_placa(self);
+  processo_t *proc = self->livres;
+  self->livres = proc->proximo_tabela;
+
+  memset(proc, 0, sizeof(*proc));
+  proc->pid = self->proximo_pid++;
+
+  // cresce antes de pôr o novo na lista, que é de onde hash_cresce reinsere
+  if (self->n + 1 > self->tam_hash) hash_cresce(self);
+  hash_insere(self, proc);
+
+  proc->anterior_tabela = self->fim;
+  if (self->fim != NULL) self->fim->proximo_tabela = proc;
+  else self->inicio = proc;
+  self->fim = proc;
+  self->n++;
+
+  return proc;
+}
+
+void tabela_proc_libera(tabela_proc_t *self, processo_t *proc)
+{
+  hash_remove(self, proc);
+
+  if (proc->anterior_tabela != NULL) {
+    proc->anterior_tabela->proximo_tabela = proc->proximo_tabela;
+  } else {
+    self->inicio = proc->proximo_tabela;
+  }
+  if (proc->proximo_tabela != NULL) {
+    proc->proximo_tabela->anterior_tabela = proc->anterior_tabela;
+  } else {
+    self->fim = proc->anterior_tabela;
+  }
+  self->n--;
+
+  proc->proximo_tabela = self->livres;
+  self->livres = proc;
+}
+
+// CONSULTA
+
+processo_t *tabela_proc_busca(tabela_proc_t *self, int pid)
+{
+  if (pid < 0) return NULL;
+  processo_t *p = self->hash[pid & (self->tam_hash - 1)];
+  while (p != NULL && p->pid != pid) p = p->proximo_hash;
+  return p;
+}
+
+bool tabela_proc_pid_usado(tabela_proc_t *self, int pid)
+{
+  return 0 <= pid && pid < self->proximo_pid;
+}
+
+int tabela_proc_n(tabela_proc_t *self)
+{
+  return self->n;
+}
+
+processo_t *tabela_proc_primeiro(tabela_proc_t *self)
+{
+  return self->inicio;
+}
+
+processo_t *tabela_proc_proximo(processo_t *proc)
+{
+  return proc->proximo_tabela;
+}
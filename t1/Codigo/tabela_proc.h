@@ -0,0 +1,55 @@
+// tabela_proc.h
+// tabela de processos do SO, que cresce conforme a necessidade
+// simulador de computador
+// so24b
+
+#ifndef TABELA_PROC_H
+#define TABELA_PROC_H
+
+// Os descritores de processo são alocados em placas de vários descritores,
+//   que nunca mudam de lugar: um ponteiro para um processo (nas filas do SO,
+//   por exemplo) vale até ele ser liberado. Um descritor liberado vai para
+//   uma lista de livres, e é reaproveitado antes de ser alocada outra placa.
+// Os processos vivos (alocados e ainda não liberados) ficam em uma lista, na
+//   ordem de criação, para que quem precisa percorrer os processos não passe
+//   pelos descritores livres. A busca por pid é feita em uma tabela hash.
+// Os pids são crescentes, e nunca são reaproveitados: um pid que não está na
+//   tabela mas é menor que o próximo a ser dado é de um processo que já
+//   terminou.
+
+#include "processo.h"
+
+#include <stdbool.h>
+
+typedef struct tabela_proc_t tabela_proc_t;
+
+// cria uma tabela vazia
+tabela_proc_t *tabela_proc_cria(void);
+
+// destrói a tabela e todos os descritores
+void tabela_proc_destroi(tabela_proc_t *self);
+
+// aloca um descritor, com um pid novo e os demais campos zerados, e o coloca
+//   no final da lista de vivos
+processo_t *tabela_proc_aloca(tabela_proc_t *self);
+
+// libera o descritor de um processo vivo; o ponteiro não vale mais
+void tabela_proc_libera(tabela_proc_t *self, processo_t *proc);
+
+// retorna o processo vivo com o pid 'pid', ou NULL
+processo_t *tabela_proc_busca(tabela_proc_t *self, int pid);
+
+// retorna true se 'pid' já foi usado por algum processo (vivo ou não)
+bool tabela_proc_pid_usado(tabela_proc_t *self, int pid);
+
+// número de processos vivos
+int tabela_proc_n(tabela_proc_t *self);
+
+// percorre os processos vivos, na ordem de criação:
+//   for (p = tabela_proc_primeiro(t); p != NULL; p = tabela_proc_proximo(p))
+// o processo corrente pode ser liberado durante o percurso, se o próximo for
+//   pego antes
+processo_t *tabela_proc_primeiro(tabela_proc_t *self);
+processo_t *tabela_proc_proximo(processo_t *proc);
+
+#endif // TABELA_PROC_H
@@ -10,6 +10,34 @@
 #include <curses.h>
 #include <locale.h>
 
+// compilado com -DTELA_MEDE (ver "make bench_tela"), soma o tempo de CPU
+//   gasto dentro das funções da tela e o informa em tela_fim
+#ifdef TELA_MEDE
+#include <stdio.h>
+#include <time.h>
+
+static long mede_chamadas;
+static double mede_segundos;
+static struct timespec mede_inicio;
+
+static void mede_comeca(void)
+{
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &mede_inicio);
+}
+
+static void mede_termina(void)
+{
+  struct timespec fim;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &fim);
+  mede_segundos += (fim.tv_sec - mede_inicio.tv_sec)
+                 + (fim.tv_nsec - mede_inicio.tv_nsec) / 1e9;
+  mede_chamadas++;
+}
+#else
+#define mede_comeca()
+#define mede_termina()
+#endif
+
 void tela_init(void)
 {
   setlocale(LC_ALL, "");  // para ter suporte a UTF8
@@ -33,6 +61,9 @@ void tela_fim()
 {
   // acaba com o curses
   endwin();
+#ifdef TELA_MEDE
+  fprintf(stderr, "tela: %ld chamadas, %.3f s de CPU\n", mede_chamadas, mede_segundos);
+#endif
 }
 
 void tela_espera(int ms)
@@ -42,28 +73,38 @@ void tela_espera(int ms)
 
 void tela_posiciona(int lin, int col)
 {
+  mede_comeca();
   move(lin, col);
+  mede_termina();
 }
 
 void tela_puts(int cor, char *str)
 {
+  mede_comeca();
   attron(COLOR_PAIR(cor));
   addstr(str);
+  mede_termina();
 }
 
 void tela_limpa_linha()
 {
+  mede_comeca();
   clrtoeol();
+  mede_termina();
 }
 
 char tela_tecla(void)
 {
+  mede_comeca();
   int ch = getch();
+  mede_termina();
   if (ch == ERR) return 0;
   return ch;
 }
 
 void tela_atualiza()
 {
+  mede_comeca();
   refresh();
+  mede_termina();
 }
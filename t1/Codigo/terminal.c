@@ -4,11 +4,16 @@
 // so24b
 
 #include "terminal.h"
+#include "anel.h"
 
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 
+// número de caracteres nas filas de entrada e de saída
+#define TAM_FILA_ENTRADA 1024
+#define TAM_FILA_SAIDA    256
+
 // TERMINAL
 
 // dados para cada terminal
@@ -16,7 +21,9 @@ struct terminal_t {
   // número de caracteres que cabem em uma linha
   int tam_linha;
   // texto já digitado no terminal, esperando para ser lido
-  char *entrada;
+  anel_t *entrada;
+  // cópia do início da entrada, para a console mostrar
+  char *txt_entrada;
   // texto sendo mostrado na saída do terminal
   char *saida;
   // normal: aceitando novos caracteres na saída
@@ -32,6 +39,15 @@ struct terminal_t {
   enum { normal, rolando, limpando } estado_saida;
   // posicao do caractere que está sendo movido durante uma rolagem
   int pos_rolagem;
+  // caracteres escritos em bloco, esperando para ir para a saída
+  anel_t *fila_saida;
+  // controlador onde são pedidas as interrupções (ou NULL)
+  pic_t *pic;
+  // arquivo onde é gravada a saída (ou NULL)
+  FILE *arquivo_saida;
+  // se as linhas mudaram desde a última consulta da console
+  bool entrada_alterada;
+  bool saida_alterada;
 };
 
 
@@ -41,57 +57,76 @@ terminal_t *terminal_cria(int tam_linha)
   assert(self != NULL);
 
   self->saida = malloc(tam_linha + 1);
-  self->entrada = malloc(tam_linha + 1);
-  assert(self->saida != NULL && self->entrada != NULL);
+  self->txt_entrada = malloc(tam_linha + 1);
+  assert(self->saida != NULL && self->txt_entrada != NULL);
 
   self->tam_linha = tam_linha;
-  strcpy(self->entrada, "");
+  self->entrada = anel_cria(TAM_FILA_ENTRADA);
+  self->fila_saida = anel_cria(TAM_FILA_SAIDA);
+  strcpy(self->txt_entrada, "");
   strcpy(self->saida, "");
   self->estado_saida = normal;
+  self->pic = NULL;
+  self->arquivo_saida = NULL;
+  self->entrada_alterada = true;
+  self->saida_alterada = true;
 
   return self;
 }
 
 void terminal_destroi(terminal_t *self)
 {
-  free(self->entrada);
+  anel_destroi(self->entrada);
+  anel_destroi(self->fila_saida);
+  free(self->txt_entrada);
   free(self->saida);
   free(self);
 }
 
-static bool terminal_entrada_vazia(terminal_t *self)
+void terminal_conecta_pic(terminal_t *self, pic_t *pic)
 {
-  return self->entrada[0] == '\0';
+  self->pic = pic;
 }
 
-static char terminal_le_char(terminal_t *self)
+static void terminal_interrompe(terminal_t *self, irq_t irq)
 {
-  char *p = self->entrada;
-  char ch = p[0];
-  if (ch != '\0') {
-    memmove(&p[0], &p[1], strlen(p));
-  }
-  return ch;
+  if (self->pic != NULL) pic_pede(self->pic, irq);
 }
 
-void terminal_insere_char(terminal_t *self, char ch)
+// a saída volta ao estado normal; se não tem mais nada na fila, volta a
+//   aceitar caracteres
+static void terminal_saida_pronta(terminal_t *self)
 {
-  char *p = self->entrada;
-  int tam = strlen(p);
-  // se não cabe, ignora silenciosamente
-  if (tam >= self->tam_linha-2) return;
-  p[tam] = ch;
-  p[tam+1] = '\0';
+  self->estado_saida = normal;
+  if (anel_vazio(self->fila_saida)) terminal_interrompe(self, IRQ_TELA);
+}
+
+static bool terminal_entrada_vazia(terminal_t *self)
+{
+  return anel_vazio(self->entrada);
 }
 
+bool terminal_insere_char(terminal_t *self, char ch)
+{
+  bool estava_vazia = terminal_entrada_vazia(self);
+  if (!anel_insere(self->entrada, ch)) return false;
+  self->entrada_alterada = true;
+  if (estava_vazia) terminal_interrompe(self, IRQ_TECLADO);
+  return true;
+}
+
+// um caractere só pode ser escrito diretamente se a saída está no estado
+//   normal e não tem caracteres na fila esperando para serem impressos
 static bool terminal_pode_imprimir(terminal_t *self)
 {
-  return self->estado_saida == normal;
+  return self->estado_saida == normal && anel_vazio(self->fila_saida);
 }
 
 static void terminal_imprime(terminal_t *self, char ch)
 {
-  if (terminal_pode_imprimir(self)) {
+  if (self->estado_saida == normal) {
+    if (self->arquivo_saida != NULL) fputc(ch, self->arquivo_saida);
+    self->saida_alterada = true;
     if (ch == '\n') {
       self->estado_saida = limpando;
       return;
@@ -110,7 +145,13 @@ static void terminal_imprime(terminal_t *self, char ch)
 void terminal_limpa_saida(terminal_t *self)
 {
   self->saida[0] = '\0';
-  self->estado_saida = normal;
+  self->saida_alterada = true;
+  if (self->estado_saida != normal) terminal_saida_pronta(self);
+}
+
+void terminal_define_arquivo_saida(terminal_t *self, FILE *arquivo)
+{
+  self->arquivo_saida = arquivo;
 }
 
 static void terminal_atualiza_rolagem(terminal_t *self)
@@ -118,12 +159,13 @@ static void terminal_atualiza_rolagem(terminal_t *self)
   // remove o caractere na posição de rolagem e avança
   // se chegou no final da string, terminou a rolagem
   char *p = self->saida;
+  self->saida_alterada = true;
   p[self->pos_rolagem] = p[self->pos_rolagem + 1];
   if (p[self->pos_rolagem] != '\0') {
     self->pos_rolagem++;
     p[self->pos_rolagem] = ' ';
   } else {
-    self->estado_saida = normal;
+    terminal_saida_pronta(self);
   }
 }
 
@@ -133,16 +175,28 @@ static void terminal_atualiza_limpeza(terminal_t *self)
   char *p = self->saida;
   int tam = strlen(p);
   memmove(p, p+1, tam);
+  self->saida_alterada = true;
   if (tam <= 1) {
-    self->estado_saida = normal;
+    terminal_saida_pronta(self);
   }
 }
 
-// altera a string de saída em 1 caractere, se estiver rolando ou limpando
+// passa o primeiro caractere da fila de saída para a saída
+static void terminal_esvazia_fila(terminal_t *self)
+{
+  char ch;
+  anel_retira(self->fila_saida, &ch);
+  terminal_imprime(self, ch);
+  if (terminal_pode_imprimir(self)) terminal_interrompe(self, IRQ_TELA);
+}
+
+// altera a string de saída em 1 caractere, se estiver rolando ou limpando,
+//   ou imprime o próximo caractere da fila
 void terminal_tictac(terminal_t *self)
 {
   switch (self->estado_saida) {
     case normal: 
+      if (!anel_vazio(self->fila_saida)) terminal_esvazia_fila(self);
       break;
     case rolando:
       terminal_atualiza_rolagem(self);
@@ -155,7 +209,8 @@ void terminal_tictac(terminal_t *self)
 
 char *terminal_txt_entrada(terminal_t *self)
 {
-  return self->entrada;
+  anel_espia(self->entrada, self->txt_entrada, self->tam_linha + 1);
+  return self->txt_entrada;
 }
 
 char *terminal_txt_saida(terminal_t *self)
@@ -163,6 +218,20 @@ char *terminal_txt_saida(terminal_t *self)
   return self->saida;
 }
 
+bool terminal_entrada_alterada(terminal_t *self)
+{
+  bool alterada = self->entrada_alterada;
+  self->entrada_alterada = false;
+  return alterada;
+}
+
+bool terminal_saida_alterada(terminal_t *self)
+{
+  bool alterada = self->saida_alterada;
+  self->saida_alterada = false;
+  return alterada;
+}
+
 // Operações de leitura e escrita no terminal, chamadas pelo controlador de E/S
 // Para o controlador, cada terminal é composto por 4 dispositivos:
 //   leitura, estado da leitura, escrita, estado da escrita
@@ -172,8 +241,12 @@ err_t terminal_leitura(void *disp, int id, int *pvalor)
 
   switch (id % 4) {
     case 0: // leitura do teclado
-      if (terminal_entrada_vazia(self)) return ERR_OCUP;
-      *pvalor = terminal_le_char(self);
+      {
+        char ch;
+        if (!anel_retira(self->entrada, &ch)) return ERR_OCUP;
+        self->entrada_alterada = true;
+        *pvalor = ch;
+      }
       break;
     case 1: // estado do teclado
       if (terminal_entrada_vazia(self)) {
@@ -216,3 +289,24 @@ err_t terminal_escrita(void *disp, int id, int valor)
   }
   return ERR_OK;
 }
+
+err_t terminal_escrita_bloco(void *disp, int id, const int *valores, int n,
+                             int *pescritos)
+{
+  terminal_t *self = disp;
+  *pescritos = 0;
+  if (id % 4 != 2) return ERR_OP_INV;
+  *pescritos = anel_insere_bloco(self->fila_saida, valores, n);
+  return ERR_OK;
+}
+
+err_t terminal_leitura_bloco(void *disp, int id, int *valores, int n, int *plidos)
+{
+  terminal_t *self = disp;
+  *plidos = 0;
+  if (id % 4 != 0) return ERR_OP_INV;
+  if (terminal_entrada_vazia(self)) return ERR_OCUP;
+  *plidos = anel_retira_bloco(self->entrada, valores, n);
+  self->entrada_alterada = true;
+  return ERR_OK;
+}
@@ -17,22 +17,35 @@
 // - escrita de um caractere na saída
 // - leitura do estado da saída (se um caractere pode ser escrito ou não)
 //
-// a leitura não é possível quando não existir caractere na entrada
-// existe um limite para caracteres digitados e não lidos; caracteres adicionais
-//   são ignorados
+// a leitura não é possível quando não existir caractere na entrada; podem ser
+//   lidos vários caracteres de uma vez (leitura em bloco)
+// existe um limite para caracteres digitados e não lidos (a capacidade da fila
+//   de entrada, bem maior que uma linha); caracteres adicionais são ignorados
+// as filas de entrada e de saída podem ser usadas por um produtor e um
+//   consumidor em threads diferentes (ver anel.h)
 // o número de caracteres na saída é limitado ao tamanho da linha. um caractere
 //   adicional causa a "rolagem", que remove o primeiro caractere da linha para
 //   gerar espaço para o novo. a impressão de um \n causa a "limpeza" da linha.
 // a escrita não é possível se a saída estiver rolando ou sendo limpa, o que é
 //   feito um caractere por vez (a cada chamada a tictac).
+// a saída também pode ser escrita em bloco: os caracteres vão para uma fila,
+//   e passam para a saída um por vez (a cada chamada a tictac, quando a saída
+//   não está rolando nem sendo limpa); enquanto a fila não esvaziar, a escrita
+//   de um caractere não é possível.
 //
 // a E/S efetiva é realizada pela console. ela obtém acesso às linhas de entrada e
 //   saída chamando terminal_txt_entrada ou terminal_txt_saida. a console insere
 //   caracteres digitados no terminal chamando terminal_insere_char, e limpa a
 //   linha de saída com terminal_limpa_saida.
-
+//
+// se ligado a um controlador de interrupções, o terminal pede IRQ_TECLADO
+//   quando chega um caractere na entrada vazia, e IRQ_TELA quando a saída
+//   volta a aceitar caracteres (no fim de uma rolagem ou limpeza, ou quando a
+//   fila de saída esvazia)
 #include <stdbool.h>
+#include <stdio.h>
 #include "es.h"
+#include "pic.h"
 
 typedef struct terminal_t terminal_t;
 
@@ -41,19 +54,36 @@ terminal_t *terminal_cria(int tam_linha);
 // libera a memória ocupada por um terminal
 void terminal_destroi(terminal_t *self);
 
-// retorna a linha de entrada do terminal (para uso pela console)
+// liga as saídas de interrupção do terminal ao controlador de interrupções
+void terminal_conecta_pic(terminal_t *self, pic_t *pic);
+
+// retorna o início da entrada do terminal, até o tamanho da linha (para uso
+//   pela console)
 char *terminal_txt_entrada(terminal_t *self);
 
 // retorna a linha de saida do terminal (para uso pela console)
 char *terminal_txt_saida(terminal_t *self);
 
+// retornam true se a linha de entrada (ou de saída) pode ter mudado desde a
+//   última chamada, e esquecem a mudança (para a console só redesenhar as
+//   linhas alteradas)
+bool terminal_entrada_alterada(terminal_t *self);
+bool terminal_saida_alterada(terminal_t *self);
+
 // insere um novo caractere na entrada do terminal
 // (para uso pela console, para simular um caractere digitado no teclado)
-void terminal_insere_char(terminal_t *self, char ch);
+// retorna false (e o caractere é perdido) se a entrada estiver cheia
+bool terminal_insere_char(terminal_t *self, char ch);
 
 // limpa a linha de saída (para uso pela console)
 void terminal_limpa_saida(terminal_t *self);
 
+// define um arquivo onde é gravado cada caractere aceito na saída, inclusive
+//   os '\n' (NULL para não gravar); a linha de saída continua sendo mantida
+//   como antes, para o tempo de impressão não depender do arquivo
+// o arquivo continua sendo de quem chamou (o terminal não o fecha)
+void terminal_define_arquivo_saida(terminal_t *self, FILE *arquivo);
+
 // esta função deve ser chamada periodicamente
 void terminal_tictac(terminal_t *self);
 
@@ -62,5 +92,12 @@ void terminal_tictac(terminal_t *self);
 // Devem seguir o protocolo f_leitura_t e f_escrita_t declarados em es.h
 err_t terminal_leitura(void *disp, int id, int *pvalor);
 err_t terminal_escrita(void *disp, int id, int valor);
+// escrita em bloco na tela (protocolo f_escrita_bloco_t); aceita tantos
+//   caracteres quantos couberem na fila de saída
+err_t terminal_escrita_bloco(void *disp, int id, const int *valores, int n,
+                             int *pescritos);
+// leitura em bloco do teclado (protocolo f_leitura_bloco_t); lê os caracteres
+//   disponíveis, até 'n'; retorna ERR_OCUP se não tem nenhum
+err_t terminal_leitura_bloco(void *disp, int id, int *valores, int n, int *plidos);
 
 #endif // TERMINAL_H
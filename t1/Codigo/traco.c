@@ -0,0 +1,83 @@
+// traco.c
+// mensagens de acompanhamento (traço) do SO, por nível e por subsistema
+// simulador de computador
+// so24b
+
+#include "traco.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+int traco_nivel = TRACO_NIVEL_PADRAO;
+unsigned traco_mascara = TRACO_TODOS;
+
+void traco_define(int nivel, unsigned mascara)
+{
+  traco_nivel = nivel;
+  traco_mascara = mascara;
+}
+
+static const char *nomes_niveis[] = { "erro", "info", "depura", "rastro" };
+#define N_NIVEIS (sizeof(nomes_niveis) / sizeof(nomes_niveis[0]))
+
+static struct {
+  const char *nome;
+  unsigned bits;
+} subsistemas[] = {
+  { "geral",   TRACO_GERAL },
+  { "irq",     TRACO_IRQ },
+  { "esc",     TRACO_ESC },
+  { "chamada", TRACO_CHAMADA },
+  { "carga",   TRACO_CARGA },
+  { "todos",   TRACO_TODOS },
+};
+#define N_SUBSISTEMAS (sizeof(subsistemas) / sizeof(subsistemas[0]))
+
+// retorna o nível com nome (ou número) 'txt' de 'tam' caracteres, ou -1
+static int pega_nivel(char *txt, int tam)
+{
+  if (tam == 1 && isdigit(txt[0])) {
+    int nivel = txt[0] - '0';
+    return nivel < N_NIVEIS ? nivel : -1;
+  }
+  for (int i = 0; i < N_NIVEIS; i++) {
+    if (strlen(nomes_niveis[i]) == tam && strncmp(txt, nomes_niveis[i], tam) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// retorna os bits do subsistema com nome 'txt' de 'tam' caracteres, ou 0
+static unsigned pega_subsistema(char *txt, int tam)
+{
+  for (int i = 0; i < N_SUBSISTEMAS; i++) {
+    if (strlen(subsistemas[i].nome) == tam
+        && strncmp(txt, subsistemas[i].nome, tam) == 0) {
+      return subsistemas[i].bits;
+    }
+  }
+  return 0;
+}
+
+bool traco_interpreta(char *txt)
+{
+  int tam = strcspn(txt, ":");
+  int nivel = pega_nivel(txt, tam);
+  if (nivel < 0) return false;
+  unsigned mascara = TRACO_TODOS;
+  if (txt[tam] == ':') {
+    mascara = 0;
+    char *p = &txt[tam + 1];
+    do {
+      tam = strcspn(p, ",");
+      unsigned bits = pega_subsistema(p, tam);
+      if (bits == 0) return false;
+      mascara |= bits;
+      p += tam;
+    } while (*p++ == ',');
+  }
+  traco_define(nivel, mascara);
+  return true;
+}
@@ -0,0 +1,86 @@
+// traco.h
+// mensagens de acompanhamento (traço) do SO, por nível e por subsistema
+// simulador de computador
+// so24b
+
+#ifndef TRACO_H
+#define TRACO_H
+
+// Cada mensagem tem um nível e um subsistema. Ela só é formatada e impressa
+//   na console se o seu nível for no máximo o nível corrente e o seu
+//   subsistema estiver na máscara corrente (os dois alteráveis durante a
+//   execução).
+// Os níveis acima de TRACO_NIVEL_MAX (definido na compilação, por exemplo
+//   com -DTRACO_NIVEL_MAX=1) não geram código nenhum.
+
+#include "console.h"
+
+#include <stdbool.h>
+
+// níveis, do mais importante ao mais detalhado
+#define TRACO_ERRO   0  // algo deu errado
+#define TRACO_INFO   1  // acontecimentos raros (carga de programas, métricas)
+#define TRACO_DEPURA 2  // cada interrupção, chamada de sistema, desbloqueio
+#define TRACO_RASTRO 3  // estado das tabelas e filas a cada escalonamento
+
+#ifndef TRACO_NIVEL_MAX
+#define TRACO_NIVEL_MAX TRACO_RASTRO
+#endif
+
+// nível corrente, se não for alterado
+#define TRACO_NIVEL_PADRAO TRACO_DEPURA
+
+// subsistemas (um bit cada)
+#define TRACO_GERAL   (1u << 0)
+#define TRACO_IRQ     (1u << 1)  // interrupções
+#define TRACO_ESC     (1u << 2)  // escalonador
+#define TRACO_CHAMADA (1u << 3)  // chamadas de sistema
+#define TRACO_CARGA   (1u << 4)  // carregador de programas
+#define TRACO_TODOS   (~0u)
+
+// nível e máscara correntes; só alterar pelas funções abaixo
+extern int traco_nivel;
+extern unsigned traco_mascara;
+
+// altera o nível e a máscara correntes
+void traco_define(int nivel, unsigned mascara);
+
+// altera o nível e a máscara a partir de um texto na forma
+//   "nível[:subsistema,subsistema...]", com nível "erro", "info", "depura"
+//   ou "rastro" (ou o número) e subsistemas "geral", "irq", "esc",
+//   "chamada", "carga" ou "todos" (o padrão)
+// retorna false (sem alterar nada) se o texto for inválido
+bool traco_interpreta(char *txt);
+
+// true se mensagens do nível e subsistema dados devem ser impressas
+// com um nível constante acima de TRACO_NIVEL_MAX, é sempre false na
+//   compilação (para envolver código que só serve para gerar mensagens)
+#define traco_ligado(nivel, sub) \
+  ((nivel) <= TRACO_NIVEL_MAX && (nivel) <= traco_nivel \
+   && ((sub) & traco_mascara) != 0)
+
+#define traco_(nivel, sub, ...) \
+  do { \
+    if (traco_ligado(nivel, sub)) console_printf(__VA_ARGS__); \
+  } while (0)
+
+// traco_xxx(subsistema, formato, ...) imprime como console_printf, se o
+//   nível xxx estiver ligado para o subsistema
+#define traco_erro(sub, ...) traco_(TRACO_ERRO, sub, __VA_ARGS__)
+#if TRACO_NIVEL_MAX >= TRACO_INFO
+#define traco_info(sub, ...) traco_(TRACO_INFO, sub, __VA_ARGS__)
+#else
+#define traco_info(sub, ...) ((void)0)
+#endif
+#if TRACO_NIVEL_MAX >= TRACO_DEPURA
+#define traco_depura(sub, ...) traco_(TRACO_DEPURA, sub, __VA_ARGS__)
+#else
+#define traco_depura(sub, ...) ((void)0)
+#endif
+#if TRACO_NIVEL_MAX >= TRACO_RASTRO
+#define traco_rastro(sub, ...) traco_(TRACO_RASTRO, sub, __VA_ARGS__)
+#else
+#define traco_rastro(sub, ...) ((void)0)
+#endif
+
+#endif // TRACO_H